@@ -0,0 +1,356 @@
+// narrowphase microbenchmarks for collision.h / primitives.h
+//
+//   ./bench/bench_collision                          print a table
+//   ./bench/bench_collision --write bench/bench_collision.baseline
+//   ./bench/bench_collision --baseline bench/bench_collision.baseline [--tolerance 0.25]
+//
+// every routine runs on three input mixes built from the same random shapes:
+// all hits, all misses, and a shuffled 50/50 mix. the gap between the pure
+// mixes and the 50/50 one is what branch mispredicts cost. each mix is
+// sampled many times, we report min / median / p90 ns per call and the
+// median throughput.
+//
+// the baseline stores each routine's fastest sample as a multiple of the
+// fastest sample of a fixed reference loop timed right before it, so clock
+// speed and load mostly cancel out (noise only ever adds time). it is
+// still recorded per machine (make bench writes one on its first run) and
+// not committed. with --baseline, a ratio more than tolerance above the
+// stored one fails the run.
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine/vec2.h"
+#include "engine/primitives.h"
+#include "engine/collision.h"
+#include "engine/rng.h"
+
+#define PI 3.14159265358979323846f
+
+#define CASES 4096              // per mix, small enough to stay in cache
+#define SAMPLES 31
+#define MIN_SAMPLE_NS 2000000.0 // grow repeats until a sample takes this long
+#define NOISE_FLOOR_NS 0.3      // ignore regressions smaller than this
+#define MAX_RESULTS 64
+
+// ─── inputs ──────────────────────────────────────────────────────
+
+// shapes are spawned in a box about twice their size, which gives a
+// reasonable hit rate for everything
+#define WORLD 20.0f
+
+static Vec2 rand_point(struct Rng *r) {
+    return vec2(rng_range(r, -WORLD, WORLD), rng_range(r, -WORLD, WORLD));
+}
+
+static struct Circle rand_circle(struct Rng *r) {
+    return (struct Circle){ rand_point(r), rng_range(r, 1.0f, 12.0f) };
+}
+
+static struct Square rand_square(struct Rng *r, float rotation) {
+    return (struct Square){ rand_point(r), rotation, rng_range(r, 2.0f, 20.0f), rng_range(r, 2.0f, 20.0f) };
+}
+
+static float rand_angle(struct Rng *r) {
+    return rng_range(r, 0.0f, 2.0f * PI);
+}
+
+static struct Line rand_line(struct Rng *r) {
+    Vec2 a = rand_point(r);
+    return (struct Line){ a, vec2_add(a, vec2(rng_range(r, -15.0f, 15.0f), rng_range(r, -15.0f, 15.0f))) };
+}
+
+struct Pair {
+    union { struct Circle c; struct Square s; struct Line l; Vec2 p; } a, b;
+};
+
+struct SatCase {
+    Vec2 a[4], b[4];
+    Vec2 axis;
+};
+
+static void gen_cc(struct Rng *r, void *o) { struct Pair *c = o; c->a.c = rand_circle(r); c->b.c = rand_circle(r); }
+static void gen_cp(struct Rng *r, void *o) { struct Pair *c = o; c->a.c = rand_circle(r); c->b.p = rand_point(r); }
+static void gen_cs(struct Rng *r, void *o) { struct Pair *c = o; c->a.c = rand_circle(r); c->b.s = rand_square(r, rand_angle(r)); }
+static void gen_sp(struct Rng *r, void *o) { struct Pair *c = o; c->a.s = rand_square(r, rand_angle(r)); c->b.p = rand_point(r); }
+static void gen_s0(struct Rng *r, void *o) { struct Pair *c = o; c->a.s = rand_square(r, 0.0f); }
+static void gen_s(struct Rng *r, void *o)  { struct Pair *c = o; c->a.s = rand_square(r, rand_angle(r)); }
+static void gen_ll(struct Rng *r, void *o) { struct Pair *c = o; c->a.l = rand_line(r); c->b.l = rand_line(r); }
+static void gen_lc(struct Rng *r, void *o) { struct Pair *c = o; c->a.l = rand_line(r); c->b.c = rand_circle(r); }
+static void gen_ls(struct Rng *r, void *o) { struct Pair *c = o; c->a.l = rand_line(r); c->b.s = rand_square(r, rand_angle(r)); }
+static void gen_lp(struct Rng *r, void *o) { struct Pair *c = o; c->a.l = rand_line(r); c->b.p = rand_point(r); }
+
+static void gen_ss(struct Rng *r, void *o) {
+    struct Pair *c = o;
+    c->a.s = rand_square(r, rand_angle(r));
+    c->b.s = rand_square(r, rand_angle(r));
+}
+
+// same rotation on both, hits the aabb fast path
+static void gen_ss_aligned(struct Rng *r, void *o) {
+    struct Pair *c = o;
+    float rot = rand_angle(r);
+    c->a.s = rand_square(r, rot);
+    c->b.s = rand_square(r, rot);
+}
+
+static void gen_sat(struct Rng *r, void *o) {
+    struct SatCase *c = o;
+    square_get_world_corners(rand_square(r, rand_angle(r)), c->a);
+    square_get_world_corners(rand_square(r, rand_angle(r)), c->b);
+    c->axis = vec2_rotate(vec2(1, 0), rand_angle(r));
+}
+
+// ─── timed loops ─────────────────────────────────────────────────
+
+// one loop per routine so the call inlines, returns the number of hits
+#define BENCH_LOOP(name, T, expr)                                       \
+static unsigned loop_##name(const void *cases_, int n) {                \
+    const T *cases = cases_;                                            \
+    unsigned hits = 0;                                                  \
+    for (int i = 0; i < n; i++) {                                       \
+        const T *c = &cases[i];                                         \
+        hits += (expr) ? 1u : 0u;                                       \
+    }                                                                   \
+    return hits;                                                        \
+}
+
+static Vec2 corner_sink[4];
+
+// the yardstick, a few flops of plain float math that no change to
+// collision.h can make faster or slower
+BENCH_LOOP(reference, struct Pair, vec2_len2(vec2_sub(c->a.c.origin, c->b.c.origin)) * c->a.c.radius > c->b.c.radius)
+
+BENCH_LOOP(circle_vs_circle,  struct Pair, circle_vs_circle(c->a.c, c->b.c))
+BENCH_LOOP(circle_vs_point,   struct Pair, circle_vs_point(c->a.c, c->b.p))
+BENCH_LOOP(circle_vs_square,  struct Pair, circle_vs_square(c->a.c, c->b.s))
+BENCH_LOOP(square_vs_point,   struct Pair, square_vs_point(c->a.s, c->b.p))
+BENCH_LOOP(square_get_corners_axis, struct Pair, (square_get_corners(c->a.s, corner_sink), corner_sink[2].x > 0.0f))
+BENCH_LOOP(square_get_corners,      struct Pair, (square_get_corners(c->a.s, corner_sink), corner_sink[2].x > 0.0f))
+BENCH_LOOP(square_get_world_corners, struct Pair, (square_get_world_corners(c->a.s, corner_sink), corner_sink[2].x > 0.0f))
+BENCH_LOOP(sat_axis_overlaps, struct SatCase, sat_axis_overlaps((Vec2 *)c->a, (Vec2 *)c->b, c->axis))
+BENCH_LOOP(square_vs_square,  struct Pair, square_vs_square(c->a.s, c->b.s))
+BENCH_LOOP(square_vs_square_aligned, struct Pair, square_vs_square(c->a.s, c->b.s))
+BENCH_LOOP(on_segment,        struct Pair, on_segment(c->a.l.start, c->a.l.end, c->b.p))
+BENCH_LOOP(orientation,       struct Pair, orientation(c->a.l.start, c->a.l.end, c->b.p) > 0.0f)
+BENCH_LOOP(line_vs_line,      struct Pair, line_vs_line(c->a.l, c->b.l))
+BENCH_LOOP(line_vs_circle,    struct Pair, line_vs_circle(c->a.l, c->b.c))
+BENCH_LOOP(line_vs_square,    struct Pair, line_vs_square(c->a.l, c->b.s))
+
+struct Routine {
+    const char *name;
+    size_t size;
+    void (*gen)(struct Rng *r, void *out);
+    unsigned (*loop)(const void *cases, int n);
+    int has_result; // 0 for routines without a hit/miss outcome
+};
+
+#define ROUTINE(name, T, gen, has_result) { #name, sizeof(T), gen, loop_##name, has_result }
+
+static const struct Routine routines[] = {
+    ROUTINE(circle_vs_circle,         struct Pair,    gen_cc,         1),
+    ROUTINE(circle_vs_point,          struct Pair,    gen_cp,         1),
+    ROUTINE(circle_vs_square,         struct Pair,    gen_cs,         1),
+    ROUTINE(square_vs_point,          struct Pair,    gen_sp,         1),
+    ROUTINE(square_get_corners_axis,  struct Pair,    gen_s0,         0),
+    ROUTINE(square_get_corners,       struct Pair,    gen_s,          0),
+    ROUTINE(square_get_world_corners, struct Pair,    gen_s,          0),
+    ROUTINE(sat_axis_overlaps,        struct SatCase, gen_sat,        1),
+    ROUTINE(square_vs_square,         struct Pair,    gen_ss,         1),
+    ROUTINE(square_vs_square_aligned, struct Pair,    gen_ss_aligned, 1),
+    ROUTINE(on_segment,               struct Pair,    gen_lp,         1),
+    ROUTINE(orientation,              struct Pair,    gen_lp,         1),
+    ROUTINE(line_vs_line,             struct Pair,    gen_ll,         1),
+    ROUTINE(line_vs_circle,           struct Pair,    gen_lc,         1),
+    ROUTINE(line_vs_square,           struct Pair,    gen_ls,         1),
+};
+
+enum Mix { MIX_HIT, MIX_MISS, MIX_MIXED };
+static const char *mix_names[] = { "hit", "miss", "mixed" };
+
+struct Result {
+    const char *routine;
+    const char *mix;
+    double min_ns, median_ns, p90_ns;
+    double mcalls_per_s;
+    double ratio; // min over the reference min
+};
+
+static volatile unsigned sink;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// fill out with CASES inputs of the requested mix, 0 if the routine
+// cant produce enough of them
+static int build_mix(const struct Routine *rt, struct Rng *r, enum Mix mix, char *out) {
+    char tmp[sizeof(struct SatCase) > sizeof(struct Pair) ? sizeof(struct SatCase) : sizeof(struct Pair)];
+    int hits = 0, misses = 0;
+    int want_hits = mix == MIX_HIT ? CASES : mix == MIX_MISS ? 0 : CASES / 2;
+    int want_misses = CASES - want_hits;
+
+    if (!rt->has_result) want_hits = CASES, want_misses = 0;
+
+    for (long tries = 0; hits + misses < CASES; tries++) {
+        if (tries > 1000L * CASES) return 0;
+        rt->gen(r, tmp);
+        int hit = rt->has_result ? rt->loop(tmp, 1) != 0 : 1;
+        if (hit && hits < want_hits) {
+            memcpy(out + (size_t)(hits + misses) * rt->size, tmp, rt->size);
+            hits++;
+        } else if (!hit && misses < want_misses) {
+            memcpy(out + (size_t)(hits + misses) * rt->size, tmp, rt->size);
+            misses++;
+        }
+    }
+
+    // shuffle so hits and misses arent predictable
+    for (int i = CASES - 1; i > 0; i--) {
+        int j = (int)(rng_next(r) % (uint32_t)(i + 1));
+        memcpy(tmp, out + (size_t)i * rt->size, rt->size);
+        memcpy(out + (size_t)i * rt->size, out + (size_t)j * rt->size, rt->size);
+        memcpy(out + (size_t)j * rt->size, tmp, rt->size);
+    }
+    return 1;
+}
+
+static struct Result measure(const struct Routine *rt, enum Mix mix, const char *cases) {
+    // warm up and find a repeat count that makes each sample long enough
+    int repeats = 1;
+    for (;;) {
+        double t0 = now_ns();
+        for (int k = 0; k < repeats; k++) sink += rt->loop(cases, CASES);
+        if (now_ns() - t0 >= MIN_SAMPLE_NS || repeats >= (1 << 20)) break;
+        repeats *= 2;
+    }
+
+    double ns[SAMPLES];
+    for (int s = 0; s < SAMPLES; s++) {
+        double t0 = now_ns();
+        for (int k = 0; k < repeats; k++) sink += rt->loop(cases, CASES);
+        ns[s] = (now_ns() - t0) / ((double)repeats * CASES);
+    }
+    qsort(ns, SAMPLES, sizeof(double), cmp_double);
+
+    struct Result res = { rt->name, mix_names[mix], ns[0], ns[SAMPLES / 2], ns[(SAMPLES * 9) / 10], 0.0, 0.0 };
+    res.mcalls_per_s = 1e3 / res.median_ns;
+    return res;
+}
+
+// baseline file is "routine mix ratio" per line, ratio to the reference
+static int compare_baseline(const char *path, const struct Result *res, int n, double tolerance,
+                            double reference_ns) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    int regressions = 0, matched = 0;
+    char name[64], mix[16];
+    double base;
+    while (fscanf(f, "%63s %15s %lf", name, mix, &base) == 3) {
+        for (int i = 0; i < n; i++) {
+            if (strcmp(res[i].routine, name) || strcmp(res[i].mix, mix)) continue;
+            matched++;
+            double limit = base * (1.0 + tolerance);
+            double floor = base + NOISE_FLOOR_NS / reference_ns;
+            if (limit < floor) limit = floor;
+            if (res[i].ratio > limit) {
+                printf("REGRESSION %-26s %-6s %7.2fx ref (baseline %.2fx, %+.0f%%)\n",
+                       name, mix, res[i].ratio, base, (res[i].ratio / base - 1.0) * 100.0);
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+
+    printf("baseline %s: %d compared, %d regressed (tolerance %.0f%%)\n",
+           path, matched, regressions, tolerance * 100.0);
+    return regressions;
+}
+
+static int write_baseline(const char *path, const struct Result *res, int n) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s %s %.4f\n", res[i].routine, res[i].mix, res[i].ratio);
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *baseline = NULL, *write = NULL, *only = NULL;
+    double tolerance = 0.25;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baseline = argv[++i];
+        else if (!strcmp(argv[i], "--write") && i + 1 < argc) write = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--only") && i + 1 < argc) only = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--baseline FILE] [--tolerance F] [--write FILE] [--only ROUTINE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    struct Rng rng;
+    rng_seed(&rng, 12345, 0);
+
+    char *cases = malloc(CASES * sizeof(struct SatCase));
+    if (!cases) return 2;
+
+    struct Result results[MAX_RESULTS];
+    int n = 0;
+
+    static const struct Routine reference = ROUTINE(reference, struct Pair, gen_cc, 0);
+    char *reference_cases = malloc(CASES * sizeof(struct Pair));
+    if (!reference_cases) return 2;
+    build_mix(&reference, &rng, MIX_MIXED, reference_cases);
+    double reference_ns = measure(&reference, MIX_MIXED, reference_cases).min_ns;
+
+    printf("reference loop %.2f ns per call\n", reference_ns);
+    printf("%-26s %-6s %9s %9s %9s %10s %8s\n", "routine", "mix", "min ns", "med ns", "p90 ns", "Mcalls/s", "x ref");
+    for (size_t r = 0; r < sizeof(routines) / sizeof(routines[0]); r++) {
+        const struct Routine *rt = &routines[r];
+        if (only && strcmp(only, rt->name)) continue;
+
+        for (int m = MIX_HIT; m <= MIX_MIXED; m++) {
+            if (!rt->has_result && m != MIX_MIXED) continue;
+            if (!build_mix(rt, &rng, (enum Mix)m, cases)) {
+                printf("%-26s %-6s     (could not build inputs)\n", rt->name, mix_names[m]);
+                continue;
+            }
+            double ref_ns = measure(&reference, MIX_MIXED, reference_cases).min_ns;
+            struct Result res = measure(rt, (enum Mix)m, cases);
+            res.ratio = res.min_ns / ref_ns;
+            printf("%-26s %-6s %9.2f %9.2f %9.2f %10.1f %8.2f\n",
+                   res.routine, res.mix, res.min_ns, res.median_ns, res.p90_ns, res.mcalls_per_s, res.ratio);
+            if (n < MAX_RESULTS) results[n++] = res;
+        }
+    }
+    free(cases);
+    free(reference_cases);
+
+    if (write && write_baseline(write, results, n)) return 2;
+    if (baseline) {
+        int regressions = compare_baseline(baseline, results, n, tolerance, reference_ns);
+        if (regressions < 0) return 2;
+        if (regressions > 0) return 1;
+    }
+    return 0;
+}
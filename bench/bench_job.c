@@ -0,0 +1,154 @@
+// parallel_for scaling on synthetic work
+//
+//   ./bench/bench_job                          print a table
+//   ./bench/bench_job --write bench/bench_job.baseline
+//   ./bench/bench_job --baseline bench/bench_job.baseline [--tolerance 0.25]
+//
+// each item burns a fixed number of sqrts (uniform) or a number growing
+// with its index (skewed, so static splits would leave threads idle). we
+// report the best of a few runs per thread count and the speedup over one
+// thread. speedup is already relative to this machine, the baseline just
+// stores it per machine like bench_collision's and fails the run when a
+// thread count lost more than tolerance of it.
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "engine/job.h"
+#include "engine/parallel.h"
+
+#define ITEMS 2048
+#define GRAIN 16
+#define REPEATS 5
+#define MAX_THREADS 16
+#define MAX_RESULTS 16
+
+struct Work {
+    int skewed;
+    double *out;
+};
+
+struct Result {
+    const char *work;
+    int threads;
+    double ms;
+    double speedup;
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void burn(void *ctx, int begin, int end) {
+    struct Work *w = ctx;
+    for (int i = begin; i < end; i++) {
+        int iters = w->skewed ? 4 * i : 4 * 1024;
+        double x = i;
+        for (int k = 0; k < iters; k++) x = sqrt(x + k);
+        w->out[i] = x;
+    }
+}
+
+static double time_burn(int threads, int skewed) {
+    static double out[ITEMS];
+    struct Work w = {skewed, out};
+    parallel_set_thread_count(threads);
+    parallel_for(ITEMS, GRAIN, burn, &w); // warm up the workers
+    double best = 1e30;
+    for (int rep = 0; rep < REPEATS; rep++) {
+        double t0 = now_ms();
+        parallel_for(ITEMS, GRAIN, burn, &w);
+        double t = now_ms() - t0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+// baseline file is "work threads speedup" per line
+static int compare_baseline(const char *path, const struct Result *res, int n, double tolerance) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    int regressions = 0, matched = 0, threads;
+    char work[16];
+    double base;
+    while (fscanf(f, "%15s %d %lf", work, &threads, &base) == 3) {
+        for (int i = 0; i < n; i++) {
+            if (strcmp(res[i].work, work) || res[i].threads != threads) continue;
+            matched++;
+            if (res[i].speedup < base * (1.0 - tolerance)) {
+                printf("REGRESSION %-8s %2d threads %5.2fx (baseline %.2fx)\n",
+                       work, threads, res[i].speedup, base);
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+
+    printf("baseline %s: %d compared, %d regressed (tolerance %.0f%%)\n",
+           path, matched, regressions, tolerance * 100.0);
+    return regressions;
+}
+
+static int write_baseline(const char *path, const struct Result *res, int n) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s %d %.4f\n", res[i].work, res[i].threads, res[i].speedup);
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *baseline = NULL, *write = NULL;
+    double tolerance = 0.25;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baseline = argv[++i];
+        else if (!strcmp(argv[i], "--write") && i + 1 < argc) write = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--baseline FILE] [--tolerance F] [--write FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // past the core count shows oversubscription overhead
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    struct Result results[MAX_RESULTS];
+    int n = 0;
+
+    printf("%-8s %8s %10s %8s\n", "work", "threads", "ms", "speedup");
+    for (int skewed = 0; skewed <= 1; skewed++) {
+        const char *work = skewed ? "skewed" : "uniform";
+        double base = time_burn(1, skewed);
+        printf("%-8s %8d %10.2f %7.2fx\n", work, 1, base, 1.0);
+        for (int t = 2; t <= 2 * cores && t <= MAX_THREADS && n < MAX_RESULTS; t *= 2) {
+            double ms = time_burn(t, skewed);
+            results[n++] = (struct Result){work, t, ms, base / ms};
+            printf("%-8s %8d %10.2f %7.2fx\n", work, t, ms, base / ms);
+        }
+    }
+    parallel_set_thread_count(0);
+    job_shutdown();
+
+    if (write && write_baseline(write, results, n)) return 2;
+    if (baseline) {
+        int regressions = compare_baseline(baseline, results, n, tolerance);
+        if (regressions) return regressions < 0 ? 2 : 1;
+    }
+    return 0;
+}
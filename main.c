@@ -1,10 +1,65 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
 #include "engine/app.h"
+#include "engine/command.h"
+#include "engine/scene.h"
+#include "engine/static_world.h"
 #include "sim/particle.h"
 
-int main() {
-    AppConfig config = {800, 600, "Physics Test"};
-    Simulation sim = particle_sim();
-    app_setup(config, &sim);
+// mouse input goes through here, the app drains it before each step
+#define COMMAND_CAPACITY 1024
+
+// ./physics-test [scene file]
+int main(int argc, char **argv) {
+    uint64_t seed = (uint64_t)time(NULL);
+
+    // without a queue the sim just runs without input. freeing a queue
+    // whose init failed is fine
+    struct CommandQueue commands;
+    int have_commands = command_queue_init(&commands, COMMAND_CAPACITY) == 0;
+
+    if (argc < 2) {
+        AppConfig config = {800, 600, "Physics Test"};
+        Simulation sim = particle_sim(seed);
+        if (sim.ctx) {
+            sim.commands = have_commands ? &commands : NULL;
+            app_setup(config, &sim);
+            sim.destroy(sim.ctx);
+        }
+        command_queue_free(&commands);
+        return sim.ctx ? 0 : 1;
+    }
+
+    struct Scene scene;
+    if (scene_load(&scene, argv[1])) {
+        perror(argv[1]);
+        command_queue_free(&commands);
+        return 1;
+    }
+
+    struct StaticWorld world;
+    if (static_world_bake(&world, scene.lines, scene.num_lines, scene.squares, scene.num_squares)) {
+        scene_unload(&scene);
+        command_queue_free(&commands);
+        return 1;
+    }
+
+    // the loader only promises a positive extent, keep the window usable
+    int sized = scene.width >= 1.0f && scene.height >= 1.0f;
+    AppConfig config = {sized ? (int)scene.width : 800, sized ? (int)scene.height : 600, argv[1]};
+    struct ParticleParams params = particle_params_default();
+    Simulation sim = particle_sim_scene(&scene, &params, seed);
+    if (sim.ctx) {
+        particle_sim_set_world(&sim, &world);
+        sim.commands = have_commands ? &commands : NULL;
+        app_setup(config, &sim);
+        sim.destroy(sim.ctx);
+    }
 
-    return 0;
+    static_world_free(&world);
+    scene_unload(&scene);
+    command_queue_free(&commands);
+    return sim.ctx ? 0 : 1;
 }
@@ -2,9 +2,44 @@
 #include "app.h"
 #include "sim/sim.h"
 
+#define COMMAND_BATCH 256
+
+// mouse tools
+#define INPUT_RADIUS 60.0f
+#define INPUT_REPEL 5000.0f
+
+void app_apply_commands(Simulation *sim) {
+    if (!sim->commands || !sim->apply) return;
+    struct Command batch[COMMAND_BATCH];
+
+    // at most one queue worth per step, so busy producers cant stall it
+    size_t budget = sim->commands->mask + 1;
+    while (budget > 0) {
+        int max = budget < COMMAND_BATCH ? (int)budget : COMMAND_BATCH;
+        int got = command_queue_pop(sim->commands, batch, max);
+        if (got == 0) break;
+        sim->apply(sim->ctx, batch, got);
+        budget -= got;
+    }
+}
+
+// left click spawns a particle, right drag repels, middle drag despawns.
+// commands land in the queue like any other producer's
+static void push_mouse_input(Simulation *sim) {
+    if (!sim->commands) return;
+    Vector2 m = GetMousePosition();
+    Vec2 at = vec2(m.x, m.y);
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+        command_queue_push(sim->commands, command_spawn(at, vec2(0, 0), 1.0f, 2.0f));
+    if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT))
+        command_queue_push(sim->commands, command_repel(at, INPUT_RADIUS, INPUT_REPEL));
+    if (IsMouseButtonDown(MOUSE_BUTTON_MIDDLE))
+        command_queue_push(sim->commands, command_despawn(at, INPUT_RADIUS));
+}
+
 void app_setup(AppConfig config, Simulation *sim) {
     // init the simulation
-    sim->init(&config);
+    sim->init(sim->ctx, &config);
 
     // init a window
     InitWindow(config.width, config.height, config.title);
@@ -17,15 +52,17 @@ void app_setup(AppConfig config, Simulation *sim) {
     while (!WindowShouldClose()) {
         float frame_time = GetFrameTime();
         accumulator += frame_time;
+        push_mouse_input(sim);
 
         while (accumulator >= FIXED_DT) {
-            sim->physics(FIXED_DT);
+            app_apply_commands(sim);
+            sim->physics(sim->ctx, FIXED_DT);
             accumulator -= FIXED_DT;
         }
 
         BeginDrawing();
         ClearBackground(WHITE);
-        sim->render();
+        sim->render(sim->ctx);
         EndDrawing();
     }
 
@@ -8,3 +8,7 @@ typedef struct AppConfig {
 
 struct Simulation;
 void app_setup(AppConfig config, struct Simulation *sim);
+
+// hand everything queued on sim->commands to sim->apply. app_setup does
+// this before every fixed step, headless loops can call it themselves
+void app_apply_commands(struct Simulation *sim);
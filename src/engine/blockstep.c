@@ -0,0 +1,71 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockstep.h"
+
+// levels are stored in a byte and 1 << max_level has to fit an int
+#define BLOCKSTEP_MAX_LEVEL 16
+
+void blockstep_init(struct BlockStep *b, int max_level, float accuracy) {
+    memset(b, 0, sizeof(*b));
+    if (max_level < 0) max_level = 0;
+    if (max_level > BLOCKSTEP_MAX_LEVEL) max_level = BLOCKSTEP_MAX_LEVEL;
+    b->max_level = max_level;
+    b->accuracy = accuracy;
+}
+
+void blockstep_free(struct BlockStep *b) {
+    free(b->level);
+    free(b->active);
+    b->level = NULL;
+    b->active = NULL;
+    b->capacity = 0;
+}
+
+int blockstep_reserve(struct BlockStep *b, int n) {
+    if (n <= b->capacity) return 0;
+    uint8_t *level = realloc(b->level, (size_t)n);
+    if (!level) return -1;
+    b->level = level;
+    int *active = realloc(b->active, (size_t)n * sizeof(int));
+    if (!active) return -1;
+    b->active = active;
+    // new particles are active on substep 0 whatever their level says
+    memset(b->level + b->capacity, 0, (size_t)(n - b->capacity));
+    b->capacity = n;
+    return 0;
+}
+
+int blockstep_gather(struct BlockStep *b, int s, int n) {
+    int count = 0;
+    if (s == 0) {
+        for (int i = 0; i < n; i++)
+            b->active[count++] = i;
+    } else {
+        // s is a multiple of exactly the strides of levels >= deepest
+        int deepest = b->max_level - __builtin_ctz((unsigned)s);
+        for (int i = 0; i < n; i++)
+            if (b->level[i] >= deepest) b->active[count++] = i;
+    }
+    b->evaluations += count;
+    return count;
+}
+
+int blockstep_choose(struct BlockStep *b, int i, int s, float accel, float speed, float dt) {
+    // largest step both limits allow
+    float step = dt;
+    if (speed > 0.0f) step = fminf(step, b->accuracy / speed);
+    if (accel > 0.0f) step = fminf(step, sqrtf(2.0f * b->accuracy / accel));
+
+    int level = 0;
+    while (level < b->max_level && step < dt * blockstep_fraction(level))
+        level++;
+
+    // coarser steps have to start on a substep they own
+    while (level < b->max_level && s % blockstep_stride(b, level))
+        level++;
+
+    b->level[i] = (uint8_t)level;
+    return level;
+}
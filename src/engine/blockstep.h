@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+// hierarchical block timesteps. a base step dt is cut into 1 << max_level
+// substeps and every particle runs at dt / 2^level for some level in
+// 0..max_level, so fast or strongly accelerated particles take small steps
+// without dragging the rest of the swarm along.
+//
+// a particle is active on the substeps where its step starts. its level is
+// picked again each time it is active, and may only get coarser on a
+// substep that is also the start of the coarser step. substep 0 starts
+// every level, so each base step begins with everything active.
+//
+//   blockstep_reserve(&b, n);
+//   for (int s = 0; s < blockstep_substeps(&b); s++) {
+//       int count = blockstep_gather(&b, s, n);
+//       ... forces on b.active[0 .. count), then per active i
+//       int level = blockstep_choose(&b, i, s, accel, speed, dt);
+//       ... kick i over dt / 2^level, drift everything over dt / substeps
+//   }
+
+struct BlockStep {
+    uint8_t *level;  // per particle
+    int *active;     // indices active on the last gathered substep
+    int capacity;
+    int max_level;
+    float accuracy;  // px a particle may move, or be bent off course, per step
+    long evaluations; // active particles summed over the substeps so far
+};
+
+void blockstep_init(struct BlockStep *b, int max_level, float accuracy);
+void blockstep_free(struct BlockStep *b);
+
+// room for n particles, returns -1 on allocation failure
+int blockstep_reserve(struct BlockStep *b, int n);
+
+static inline int blockstep_substeps(const struct BlockStep *b) {
+    return 1 << b->max_level;
+}
+
+// substeps between the starts of two steps on level
+static inline int blockstep_stride(const struct BlockStep *b, int level) {
+    return 1 << (b->max_level - level);
+}
+
+// fraction of the base step a particle on level covers
+static inline float blockstep_fraction(int level) {
+    return 1.0f / (float)(1 << level);
+}
+
+// fills b->active with the particles whose step starts on substep s and
+// returns how many there are. on s == 0 that is everyone
+int blockstep_gather(struct BlockStep *b, int s, int n);
+
+// level for particle i, active on substep s, from its acceleration and
+// speed (per second). the step is the largest power of two fraction of dt
+// with speed * step <= accuracy and 0.5 * accel * step^2 <= accuracy
+int blockstep_choose(struct BlockStep *b, int i, int s, float accel, float speed, float dt);
@@ -13,6 +13,13 @@ static inline bool circle_vs_circle(struct Circle a, struct Circle b) {
     return dist2 <= radii * radii + COLLISION_EPSILON;
 }
 
+// circle_vs_circle against the image of b nearest to a, in a world
+// that wraps with the given period (see vec2_sub_periodic)
+static inline bool circle_vs_circle_periodic(struct Circle a, struct Circle b, Vec2 period) {
+    b.origin = vec2_add(a.origin, vec2_sub_periodic(b.origin, a.origin, period));
+    return circle_vs_circle(a, b);
+}
+
 static inline bool circle_vs_point(struct Circle c, Vec2 p) {
     float dist = vec2_dist(c.origin, p);
     return dist <= c.radius + COLLISION_EPSILON;
@@ -107,7 +114,7 @@ static inline bool square_vs_square(struct Square a, struct Square b) {
 }
 
 // line vs else
-float orientation(Vec2 a, Vec2 b, Vec2 c) {
+static inline float orientation(Vec2 a, Vec2 b, Vec2 c) {
     Vec2 ab = vec2_sub(b, a);
     Vec2 ac = vec2_sub(c, a);
     return ab.x * ac.y - ab.y * ac.x;
@@ -118,7 +125,7 @@ static inline bool on_segment(Vec2 a, Vec2 b, Vec2 p) {
         && fminf(a.y, b.y) - COLLISION_EPSILON <= p.y && p.y <= fmaxf(a.y, b.y) + COLLISION_EPSILON;
 }
 
-bool line_vs_line(struct Line a, struct Line b) {
+static inline bool line_vs_line(struct Line a, struct Line b) {
     Vec2 d1 = vec2_sub(a.end, a.start);
     Vec2 d2 = vec2_sub(b.end, b.start);
     float cross = d1.x * d2.y - d1.y * d2.x;
@@ -140,7 +147,7 @@ bool line_vs_line(struct Line a, struct Line b) {
         && u >= -COLLISION_EPSILON && u <= 1.0f + COLLISION_EPSILON;
 }
 
-bool line_vs_circle(struct Line l, struct Circle c) {
+static inline bool line_vs_circle(struct Line l, struct Circle c) {
     Vec2 ab = vec2_sub(l.end, l.start);
     Vec2 ac = vec2_sub(c.origin, l.start);
 
@@ -160,7 +167,7 @@ bool line_vs_circle(struct Line l, struct Circle c) {
     return dist2 <= c.radius * c.radius + COLLISION_EPSILON;
 }
 
-bool line_vs_square(struct Line l, struct Square s) {
+static inline bool line_vs_square(struct Line l, struct Square s) {
     // either endpoint inside the square
     if (square_vs_point(s, l.start) || square_vs_point(s, l.end))
         return true;
@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "command.h"
+
+int command_queue_init(struct CommandQueue *q, size_t capacity) {
+    memset(q, 0, sizeof(*q));
+    size_t cap = 2;
+    while (cap < capacity) cap *= 2;
+
+    q->slots = malloc(cap * sizeof(struct CommandSlot));
+    if (!q->slots) return -1;
+    for (size_t i = 0; i < cap; i++) q->slots[i].seq = i;
+    q->mask = cap - 1;
+    return 0;
+}
+
+void command_queue_free(struct CommandQueue *q) {
+    free(q->slots);
+    memset(q, 0, sizeof(*q));
+}
+
+int command_queue_push(struct CommandQueue *q, struct Command cmd) {
+    size_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    struct CommandSlot *slot;
+    for (;;) {
+        slot = &q->slots[pos & q->mask];
+        size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            // slot is free for this lap, claim it. a failed cas reloads pos
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (diff < 0) {
+            // consumer hasnt freed it since the last lap: full
+            __atomic_fetch_add(&q->dropped, 1, __ATOMIC_RELAXED);
+            return -1;
+        } else {
+            // someone else claimed pos, catch up
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->cmd = cmd;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int command_queue_pop(struct CommandQueue *q, struct Command *out, int max) {
+    int got = 0;
+    size_t pos = q->tail;
+    while (got < max) {
+        struct CommandSlot *slot = &q->slots[pos & q->mask];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1) break;
+        out[got++] = slot->cmd;
+        // free for the producers' next lap
+        __atomic_store_n(&slot->seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+        pos++;
+    }
+    q->tail = pos;
+    return got;
+}
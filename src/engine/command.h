@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include "vec2.h"
+
+// input for a running sim from any thread. producers push into a bounded
+// lock-free queue (vyukov style, one sequence number per slot) and never
+// block, a full queue just drops the command. the app loop is the single
+// consumer, it drains the queue at the start of each fixed step and hands
+// the sim whole batches, so the step never takes a lock.
+//
+// a sim may refuse kinds it cant honour instead of half applying them.
+// the particle sim refuses spawn and despawn under its xpbd solver, whose
+// lattice constraints name particles by index, and counts every refused
+// command in ParticleStats.rejected.
+//
+//   struct CommandQueue q;
+//   command_queue_init(&q, 4096);
+//   sim.commands = &q;
+//   ... any thread
+//   command_queue_push(&q, command_repel(mouse, 200.0f, 5000.0f));
+
+enum CommandKind {
+    COMMAND_SPAWN,   // new particle at p with velocity v, mass a, radius b
+    COMMAND_DESPAWN, // remove particles within b of p
+    COMMAND_IMPULSE, // add v to the velocity of particles within b of p
+    COMMAND_REPEL,   // particle_repel(p, a) on particles within b of p
+};
+
+struct Command {
+    enum CommandKind kind;
+    Vec2 p;
+    Vec2 v;
+    float a, b; // radius b <= 0 means every particle
+};
+
+// constructors. area commands take (point, radius, payload)
+static inline struct Command command_spawn(Vec2 position, Vec2 velocity, float mass, float radius) {
+    return (struct Command){COMMAND_SPAWN, position, velocity, mass, radius};
+}
+
+static inline struct Command command_despawn(Vec2 point, float radius) {
+    return (struct Command){COMMAND_DESPAWN, point, vec2(0, 0), 0.0f, radius};
+}
+
+static inline struct Command command_impulse(Vec2 point, float radius, Vec2 dv) {
+    return (struct Command){COMMAND_IMPULSE, point, dv, 0.0f, radius};
+}
+
+static inline struct Command command_repel(Vec2 point, float radius, float strength) {
+    return (struct Command){COMMAND_REPEL, point, vec2(0, 0), strength, radius};
+}
+
+struct CommandSlot {
+    size_t seq; // == position when free, position + 1 once written
+    struct Command cmd;
+};
+
+struct CommandQueue {
+    struct CommandSlot *slots;
+    size_t mask;
+    char pad0[64];
+    size_t head;    // next position to claim, producers
+    char pad1[64];
+    size_t tail;    // next position to read, consumer only
+    char pad2[64];
+    size_t dropped; // pushes that found the queue full
+};
+
+// capacity is rounded up to a power of two. returns -1 on allocation failure
+int command_queue_init(struct CommandQueue *q, size_t capacity);
+void command_queue_free(struct CommandQueue *q);
+
+// any thread. returns -1 if the queue was full
+int command_queue_push(struct CommandQueue *q, struct Command cmd);
+
+// consumer only. copies out up to max commands in push order and returns
+// how many. stops early at a slot a producer claimed but hasnt written yet
+int command_queue_pop(struct CommandQueue *q, struct Command *out, int max);
@@ -0,0 +1,218 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "contact.h"
+#include "collision.h"
+
+#define CONTACT_MAX_WALL_HITS 16
+
+static inline uint64_t contact_key(uint32_t a, uint32_t b) {
+    return a < b ? (uint64_t)a << 32 | b : (uint64_t)b << 32 | a;
+}
+
+int contact_events_init(struct ContactEvents *ce, int ring_capacity) {
+    memset(ce, 0, sizeof(*ce));
+    uint64_t cap = 2;
+    while (cap < (uint64_t)ring_capacity) cap *= 2;
+
+    ce->ring = malloc(cap * sizeof(struct ContactEvent));
+    if (!ce->ring) return -1;
+    ce->ring_mask = cap - 1;
+    ce->persist = 1;
+    return 0;
+}
+
+void contact_events_free(struct ContactEvents *ce) {
+    free(ce->keys);
+    free(ce->prev);
+    free(ce->tmp);
+    free(ce->ring);
+    cell_grid_free(&ce->grid);
+    memset(ce, 0, sizeof(*ce));
+}
+
+void contact_events_clear(struct ContactEvents *ce) {
+    ce->count = 0;
+}
+
+// keys, prev and tmp trade places so they all share one capacity
+static int reserve(struct ContactEvents *ce, int n) {
+    if (n <= ce->capacity) return 0;
+    int cap = ce->capacity ? ce->capacity * 2 : 1024;
+    while (cap < n) cap *= 2;
+
+    uint64_t **arrays[] = {&ce->keys, &ce->prev, &ce->tmp};
+    for (int i = 0; i < 3; i++) {
+        uint64_t *a = realloc(*arrays[i], (size_t)cap * sizeof(uint64_t));
+        if (!a) return -1;
+        *arrays[i] = a;
+    }
+    ce->capacity = cap;
+    return 0;
+}
+
+int contact_events_add(struct ContactEvents *ce, uint32_t a, uint32_t b) {
+    if (reserve(ce, ce->count + 1)) return -1;
+    ce->keys[ce->count++] = contact_key(a, b);
+    return 0;
+}
+
+void contact_find_particles(struct ContactEvents *ce, const struct Particle *particles,
+                            const int *ids, int n) {
+    if (n < 2) return;
+
+    float max_r = 0.0f;
+    for (int i = 0; i < n; i++)
+        if (particles[i].radius > max_r) max_r = particles[i].radius;
+    if (max_r <= 0.0f) return;
+
+    struct CellGrid *g = &ce->grid;
+    int periodic = ce->period.x > 0.0f;
+    int built = periodic
+        ? cell_grid_build_periodic(g, particles, n, 2.0f * max_r, ce->lo, ce->period)
+        : cell_grid_build(g, particles, n, 2.0f * max_r);
+    if (built) return;
+
+    for (int i = 0; i < n; i++) {
+        struct Circle ci = {particles[i].position, particles[i].radius};
+        int cells[9];
+        int num_cells = cell_grid_neighbors(g, cell_grid_cell(g, ci.origin), cells);
+
+        for (int m = 0; m < num_cells; m++) {
+            int c = cells[m];
+            for (int k = g->start[c]; k < g->start[c + 1]; k++) {
+                int j = g->items[k];
+                if (j <= i) continue;
+                struct Circle cj = {particles[j].position, particles[j].radius};
+                int hit = periodic ? circle_vs_circle_periodic(ci, cj, ce->period) : circle_vs_circle(ci, cj);
+                if (!hit) continue;
+                uint32_t a = ids ? (uint32_t)ids[i] : (uint32_t)i, b = ids ? (uint32_t)ids[j] : (uint32_t)j;
+                if (contact_events_add(ce, a, b)) return;
+            }
+        }
+    }
+}
+
+void contact_find_world(struct ContactEvents *ce, const struct StaticWorld *w,
+                        const struct Particle *particles, const int *ids, int n) {
+    int hits[CONTACT_MAX_WALL_HITS];
+    for (int i = 0; i < n; i++) {
+        struct Circle c = {particles[i].position, particles[i].radius};
+        int got = static_world_query_circle(w, c, hits, CONTACT_MAX_WALL_HITS);
+        if (got > CONTACT_MAX_WALL_HITS) got = CONTACT_MAX_WALL_HITS;
+        uint32_t a = ids ? (uint32_t)ids[i] : (uint32_t)i;
+        for (int k = 0; k < got; k++)
+            if (contact_events_add(ce, a, CONTACT_STATIC | (uint32_t)hits[k])) return;
+    }
+}
+
+// lsd radix sort on bytes, skipping every byte all keys agree on. with
+// small particle counts most of the 8 bytes are skipped
+static void sort_keys(uint64_t *keys, uint64_t *tmp, int n) {
+    int hist[8][256] = {{0}};
+    for (int i = 0; i < n; i++)
+        for (int d = 0; d < 8; d++)
+            hist[d][(keys[i] >> (8 * d)) & 0xff]++;
+
+    uint64_t *src = keys, *dst = tmp;
+    for (int d = 0; d < 8; d++) {
+        if (hist[d][(keys[0] >> (8 * d)) & 0xff] == n) continue;
+        int sum = 0;
+        for (int b = 0; b < 256; b++) {
+            int c = hist[d][b];
+            hist[d][b] = sum;
+            sum += c;
+        }
+        for (int i = 0; i < n; i++)
+            dst[hist[d][(src[i] >> (8 * d)) & 0xff]++] = src[i];
+        uint64_t *t = src; src = dst; dst = t;
+    }
+    if (src != keys) memcpy(keys, src, (size_t)n * sizeof(uint64_t));
+}
+
+// sorted and without duplicates, returns the new count
+static int sort_unique(uint64_t *keys, uint64_t *tmp, int n) {
+    if (n < 2) return n;
+    sort_keys(keys, tmp, n);
+    int out = 1;
+    for (int i = 1; i < n; i++)
+        if (keys[i] != keys[out - 1]) keys[out++] = keys[i];
+    return out;
+}
+
+static inline void emit(struct ContactEvents *ce, uint64_t key, enum ContactEventKind kind) {
+    struct ContactEvent *e = &ce->ring[ce->head & ce->ring_mask];
+    e->a = (uint32_t)(key >> 32);
+    e->b = (uint32_t)key;
+    e->kind = kind;
+    e->step = ce->step;
+    ce->head++;
+}
+
+void contact_events_remap(struct ContactEvents *ce, const int *remap) {
+    int out = 0;
+    for (int i = 0; i < ce->prev_count; i++) {
+        uint32_t a = (uint32_t)(ce->prev[i] >> 32), b = (uint32_t)ce->prev[i];
+        int na = remap[a];
+        int nb = b & CONTACT_STATIC ? 0 : remap[b];
+        if (na < 0 || nb < 0) {
+            emit(ce, ce->prev[i], CONTACT_END);
+            continue;
+        }
+        ce->prev[out++] = contact_key((uint32_t)na, b & CONTACT_STATIC ? b : (uint32_t)nb);
+    }
+    ce->prev_count = sort_unique(ce->prev, ce->tmp, out);
+}
+
+// ids keep their order, so prev stays sorted
+void contact_events_remove(struct ContactEvents *ce, const int *index_of) {
+    int out = 0;
+    for (int i = 0; i < ce->prev_count; i++) {
+        uint32_t a = (uint32_t)(ce->prev[i] >> 32), b = (uint32_t)ce->prev[i];
+        if (index_of[a] < 0 || (!(b & CONTACT_STATIC) && index_of[b] < 0)) {
+            emit(ce, ce->prev[i], CONTACT_END);
+            continue;
+        }
+        ce->prev[out++] = ce->prev[i];
+    }
+    ce->prev_count = out;
+}
+
+void contact_events_commit(struct ContactEvents *ce) {
+    int n = sort_unique(ce->keys, ce->tmp, ce->count);
+    const uint64_t *cur = ce->keys, *prev = ce->prev;
+    int i = 0, j = 0;
+
+    // both sides sorted, so one merge finds every change
+    while (i < n && j < ce->prev_count) {
+        if (cur[i] < prev[j]) {
+            emit(ce, cur[i++], CONTACT_BEGIN);
+        } else if (prev[j] < cur[i]) {
+            emit(ce, prev[j++], CONTACT_END);
+        } else {
+            if (ce->persist) emit(ce, cur[i], CONTACT_PERSIST);
+            i++;
+            j++;
+        }
+    }
+    while (i < n) emit(ce, cur[i++], CONTACT_BEGIN);
+    while (j < ce->prev_count) emit(ce, prev[j++], CONTACT_END);
+
+    // this step becomes the previous one
+    uint64_t *t = ce->prev;
+    ce->prev = ce->keys;
+    ce->keys = t;
+    ce->prev_count = n;
+    ce->count = 0;
+    ce->step++;
+}
+
+int contact_events_read(const struct ContactEvents *ce, uint64_t *cursor, struct ContactEvent *out, int max) {
+    uint64_t size = ce->ring_mask + 1;
+    if (ce->head - *cursor > size) *cursor = ce->head - size;
+
+    int got = 0;
+    while (got < max && *cursor < ce->head)
+        out[got++] = ce->ring[(*cursor)++ & ce->ring_mask];
+    return got;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include "vec2.h"
+#include "particle.h"
+#include "grid.h"
+#include "static_world.h"
+
+// contact begin / persist / end events without per pair callbacks.
+// each step the touching pairs are collected as 64 bit keys, sorted, and
+// merged against the previous step's keys. the difference is appended to
+// a preallocated ring that any number of readers walk after the step,
+// each with its own cursor.
+//
+// pairs are keyed by stable particle ids (morton.h), so storage reorders
+// dont look like contacts ending and beginning, and readers can follow a
+// particle across steps.
+//
+//   contact_events_clear(&ce);
+//   contact_find_particles(&ce, particles, morton.ids, n);
+//   contact_find_world(&ce, world, particles, morton.ids, n);
+//   contact_events_commit(&ce);
+//   ... after the step
+//   struct ContactEvent buf[256];
+//   int got;
+//   while ((got = contact_events_read(&ce, &cursor, buf, 256)) > 0) ...
+
+// set on b when it is an index into StaticWorld.shapes instead of a particle
+#define CONTACT_STATIC 0x80000000u
+
+enum ContactEventKind {
+    CONTACT_BEGIN,
+    CONTACT_PERSIST,
+    CONTACT_END,
+};
+
+struct ContactEvent {
+    uint32_t a, b; // a < b, stable particle ids
+    enum ContactEventKind kind;
+    uint32_t step;
+};
+
+struct ContactEvents {
+    uint64_t *keys;  // this step, sorted by commit
+    uint64_t *prev;  // last step, sorted
+    uint64_t *tmp;   // radix sort scratch
+    int count, prev_count, capacity;
+
+    struct ContactEvent *ring;
+    uint64_t ring_mask;
+    uint64_t head;   // events ever written, ring[head & ring_mask] is next
+
+    uint32_t step;
+    int persist;     // emit persist events too, on by default
+    Vec2 lo, period; // periodic box for particle pairs, period (0, 0) when open
+    struct CellGrid grid;
+};
+
+// ring_capacity is rounded up to a power of two. returns -1 on allocation failure
+int contact_events_init(struct ContactEvents *ce, int ring_capacity);
+void contact_events_free(struct ContactEvents *ce);
+
+// start collecting this step's pairs
+void contact_events_clear(struct ContactEvents *ce);
+int contact_events_add(struct ContactEvents *ce, uint32_t a, uint32_t b);
+
+// every overlapping particle pair, grid broadphase + circle_vs_circle.
+// pairs touch across the box edges when period is set. ids[i] is the
+// stable id of particles[i], NULL uses the index
+void contact_find_particles(struct ContactEvents *ce, const struct Particle *particles,
+                            const int *ids, int n);
+
+// every particle touching a static shape, b is CONTACT_STATIC | shape index
+void contact_find_world(struct ContactEvents *ce, const struct StaticWorld *w,
+                        const struct Particle *particles, const int *ids, int n);
+
+// ids were renumbered, remap[old] == new or -1 if removed. only needed
+// when ids arent stable (ids NULL and storage moved). pairs with a removed
+// particle end right away, their END event carries the old ids
+void contact_events_remap(struct ContactEvents *ce, const int *remap);
+
+// ids with index_of[id] < 0 were removed (morton_remove). their pairs end
+// right away with an END event. call it before the ids are handed out again
+void contact_events_remove(struct ContactEvents *ce, const int *index_of);
+
+// sort, diff against last step and write the events
+void contact_events_commit(struct ContactEvents *ce);
+
+// copy out up to max events after *cursor and advance it. a reader that
+// fell more than a ring behind skips ahead to the oldest event still there
+int contact_events_read(const struct ContactEvents *ce, uint64_t *cursor, struct ContactEvent *out, int max);
@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "export.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// frames start one cache line in so the header never shares a line with them
+#define EXPORT_HEADER_SIZE 64
+
+// a reader gives up after this many torn copies in a row
+#define EXPORT_READ_RETRIES 16
+
+static struct ExportFrame *frame_at(const struct ExportHeader *h, uint64_t number) {
+    size_t slot = (size_t)(number % h->num_frames);
+    return (struct ExportFrame *)((char *)h + EXPORT_HEADER_SIZE + slot * h->frame_size);
+}
+
+// ─── writer ───
+
+// unlinks name if it holds an export whose writer is gone. anything else
+// (a live writer, a pid reused since, a half created object, something
+// that isnt an export) fails with EEXIST, readers of it keep their frames
+static int unlink_if_stale(const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return errno == ENOENT ? 0 : -1; // went away meanwhile
+
+    pid_t pid = 0;
+    struct stat st;
+    if (!fstat(fd, &st) && (size_t)st.st_size >= EXPORT_HEADER_SIZE) {
+        void *mem = mmap(NULL, EXPORT_HEADER_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+        if (mem != MAP_FAILED) {
+            const struct ExportHeader *h = mem;
+            if (!memcmp(h->magic, EXPORT_MAGIC, sizeof(h->magic))) pid = (pid_t)h->writer_pid;
+            munmap(mem, EXPORT_HEADER_SIZE);
+        }
+    }
+    close(fd);
+
+    if (pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH) {
+        errno = EEXIST;
+        return -1;
+    }
+    if (shm_unlink(name) && errno != ENOENT) return -1;
+    return 0;
+}
+
+int export_create(struct Exporter *ex, const char *name, int num_frames, int max_particles) {
+    memset(ex, 0, sizeof(*ex));
+    if (num_frames < 1 || max_particles < 1 || strlen(name) >= sizeof(ex->name)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint64_t frame_size = EXPORT_FRAME_DATA + (uint64_t)max_particles * sizeof(struct Particle);
+    frame_size = (frame_size + 63) & ~(uint64_t)63;
+    size_t size = EXPORT_HEADER_SIZE + (size_t)num_frames * frame_size;
+
+    // a crashed run can leave its object behind, replace only that
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        if (unlink_if_stale(name)) return -1;
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) return -1;
+    if (ftruncate(fd, (off_t)size)) {
+        int e = errno;
+        close(fd);
+        shm_unlink(name);
+        errno = e;
+        return -1;
+    }
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        int e = errno;
+        shm_unlink(name);
+        errno = e;
+        return -1;
+    }
+
+    // ftruncate zeroed everything, so every seq starts even and latest at 0
+    struct ExportHeader *h = mem;
+    h->version = EXPORT_VERSION;
+    h->num_frames = (uint32_t)num_frames;
+    h->max_particles = (uint32_t)max_particles;
+    h->record_size = sizeof(struct Particle);
+    h->position_offset = offsetof(struct Particle, position);
+    h->velocity_offset = offsetof(struct Particle, linear_velocity);
+    h->frame_size = frame_size;
+    h->writer_pid = (uint32_t)getpid();
+    // magic last, readers that see it see the rest
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(h->magic, EXPORT_MAGIC, sizeof(h->magic));
+
+    ex->header = h;
+    ex->size = size;
+    strcpy(ex->name, name);
+    ex->decimate = 1;
+    ex->every = 1;
+    return 0;
+}
+
+void export_destroy(struct Exporter *ex) {
+    if (!ex->header) return;
+    munmap(ex->header, ex->size);
+    shm_unlink(ex->name);
+    ex->header = NULL;
+}
+
+void export_publish(struct Exporter *ex, const struct Particle *particles, int n, double time) {
+    struct ExportHeader *h = ex->header;
+    if (!h || n < 0) return;
+    if (ex->every > 1 && ex->calls++ % (uint64_t)ex->every) return;
+
+    const uint32_t d = ex->decimate > 1 ? (uint32_t)ex->decimate : 1;
+    uint32_t count = (uint32_t)(((uint64_t)n + d - 1) / d);
+    if (count > h->max_particles) count = h->max_particles;
+
+    // only this process writes latest, a relaxed load is enough
+    uint64_t number = __atomic_load_n(&h->latest, __ATOMIC_RELAXED) + 1;
+    struct ExportFrame *f = frame_at(h, number);
+    uint64_t seq = f->seq;
+
+    // odd seq, then the fence keeps the copy below from moving above it
+    __atomic_store_n(&f->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    f->number = number;
+    f->time = time;
+    f->count = count;
+    f->decimate = d;
+    char *data = (char *)f + EXPORT_FRAME_DATA;
+    if (d == 1) {
+        memcpy(data, particles, (size_t)count * sizeof(struct Particle));
+    } else {
+        struct Particle *out = (struct Particle *)data;
+        for (uint32_t i = 0; i < count; i++)
+            out[i] = particles[(size_t)i * d];
+    }
+
+    __atomic_store_n(&f->seq, seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&h->latest, number, __ATOMIC_RELEASE);
+}
+
+// ─── reader ───
+
+int export_open(struct ExportReader *rd, const char *name) {
+    memset(rd, 0, sizeof(*rd));
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st)) {
+        int e = errno;
+        close(fd);
+        errno = e;
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size < EXPORT_HEADER_SIZE) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void *mem = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return -1;
+
+    const struct ExportHeader *h = mem;
+    if (memcmp(h->magic, EXPORT_MAGIC, sizeof(h->magic)) || h->version != EXPORT_VERSION ||
+        h->num_frames == 0 || h->frame_size < EXPORT_FRAME_DATA ||
+        (uint64_t)h->max_particles * h->record_size > h->frame_size - EXPORT_FRAME_DATA ||
+        size < EXPORT_HEADER_SIZE + (uint64_t)h->num_frames * h->frame_size) {
+        munmap(mem, size);
+        errno = EINVAL;
+        return -1;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    rd->copy = malloc((size_t)h->frame_size);
+    if (!rd->copy) {
+        munmap(mem, size);
+        errno = ENOMEM;
+        return -1;
+    }
+    rd->header = h;
+    rd->size = size;
+    return 0;
+}
+
+void export_close(struct ExportReader *rd) {
+    if (rd->header) munmap((void *)rd->header, rd->size);
+    free(rd->copy);
+    rd->header = NULL;
+    rd->copy = NULL;
+}
+
+int export_read_latest(struct ExportReader *rd, const struct ExportFrame **frame) {
+    const struct ExportHeader *h = rd->header;
+    struct ExportFrame *out = rd->copy;
+
+    for (int tries = 0; tries < EXPORT_READ_RETRIES; tries++) {
+        uint64_t latest = __atomic_load_n(&h->latest, __ATOMIC_ACQUIRE);
+        if (latest == 0) return 0;
+        const struct ExportFrame *f = frame_at(h, latest);
+
+        uint64_t seq = __atomic_load_n(&f->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) continue; // writer lapped us into this slot
+
+        memcpy(out, f, EXPORT_FRAME_DATA);
+        // count may be torn, clamp it so the copy stays in bounds
+        uint32_t count = out->count <= h->max_particles ? out->count : h->max_particles;
+        memcpy((char *)out + EXPORT_FRAME_DATA, (const char *)f + EXPORT_FRAME_DATA,
+               (size_t)count * h->record_size);
+
+        // seq unchanged means nothing above was written while we copied
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&f->seq, __ATOMIC_RELAXED) != seq) continue;
+
+        out->seq = seq;
+        rd->last = out->number;
+        *frame = out;
+        return 1;
+    }
+    return -1;
+}
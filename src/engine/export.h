@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "particle.h"
+
+// live particle state for other processes. a sim publishes frames into a
+// posix shared memory ring, readers map the same name read only.
+//
+// every frame slot is a seqlock: the writer makes seq odd, copies the
+// particles in (one memcpy of the raw struct Particle records unless
+// decimated), makes seq even again and then bumps header->latest.
+// the writer never looks at readers. a reader copies a slot out and keeps
+// it only if seq was even and unchanged around the copy, and with several
+// slots the writer is never in the slot a reader is after unless the
+// reader is a whole ring behind.
+//
+//   writer                                  reader
+//   export_create(&ex, "/physics", 8, n);   export_open(&rd, "/physics");
+//   ... each step                           ... whenever
+//   export_publish(&ex, particles, n, t);   export_read_latest(&rd, &frame);
+
+#define EXPORT_MAGIC "PEXPORT"
+#define EXPORT_VERSION 1
+
+struct ExportHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_frames;
+    uint32_t max_particles;   // per frame
+    uint32_t record_size;     // sizeof(struct Particle) of the writer
+    uint32_t position_offset; // of the Vec2 position in a record
+    uint32_t velocity_offset; // of the Vec2 linear_velocity in a record
+    uint64_t frame_size;      // bytes per slot, header included
+    uint64_t latest;          // last complete frame number, 0 before any
+    uint32_t writer_pid;      // creator, tells a stale object from a live one
+};
+
+struct ExportFrame {
+    uint64_t seq;     // odd while the writer is in this slot
+    uint64_t number;  // frame number, slot is number % num_frames
+    double time;      // sim time passed to publish
+    uint32_t count;   // records that follow
+    uint32_t decimate;
+    // count records of record_size bytes follow, 64 byte aligned
+};
+
+#define EXPORT_FRAME_DATA 64
+
+struct Exporter {
+    struct ExportHeader *header;
+    size_t size;
+    char name[64];
+    int decimate; // publish every decimate-th particle, 1 is all of them
+    int every;    // publish every every-th call, 1 is all of them
+    uint64_t calls;
+};
+
+// creates the shared memory object. an object left under name by a writer
+// that died is replaced, one whose writer is alive (or unknown) is left
+// alone for its readers and this fails with EEXIST. returns -1 with errno set
+int export_create(struct Exporter *ex, const char *name, int num_frames, int max_particles);
+
+// unmaps and unlinks the name
+void export_destroy(struct Exporter *ex);
+
+// copies particles into the next slot. particles past max_particles (after
+// decimation) are dropped. never blocks
+void export_publish(struct Exporter *ex, const struct Particle *particles, int n, double time);
+
+struct ExportReader {
+    const struct ExportHeader *header;
+    size_t size;
+    void *copy;   // one frame, the reader's private snapshot
+    uint64_t last; // frame number of the last successful read
+};
+
+// maps an existing export read only. returns -1 with errno set
+int export_open(struct ExportReader *rd, const char *name);
+void export_close(struct ExportReader *rd);
+
+// a consistent copy of the newest frame, *frame points into rd->copy and
+// stays valid until the next read. returns 1 on success, 0 if nothing has
+// been published yet, -1 if the writer lapped every retry
+int export_read_latest(struct ExportReader *rd, const struct ExportFrame **frame);
+
+// record i of a frame read with export_read_latest
+static inline Vec2 export_position(const struct ExportReader *rd, const struct ExportFrame *f, uint32_t i) {
+    const char *r = (const char *)f + EXPORT_FRAME_DATA + (size_t)i * rd->header->record_size;
+    Vec2 v;
+    memcpy(&v, r + rd->header->position_offset, sizeof(v));
+    return v;
+}
+
+static inline Vec2 export_velocity(const struct ExportReader *rd, const struct ExportFrame *f, uint32_t i) {
+    const char *r = (const char *)f + EXPORT_FRAME_DATA + (size_t)i * rd->header->record_size;
+    Vec2 v;
+    memcpy(&v, r + rd->header->velocity_offset, sizeof(v));
+    return v;
+}
@@ -0,0 +1,131 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fft.h"
+#include "parallel.h"
+
+#define FFT_PI 3.14159265358979323846
+
+int fft_init(struct Fft *f, int n) {
+    memset(f, 0, sizeof(*f));
+    if (n < 2 || (n & (n - 1))) return -1;
+
+    f->n = n;
+    while ((1 << f->log2n) < n) f->log2n++;
+
+    f->cos_t = malloc((n / 2) * sizeof(float));
+    f->sin_t = malloc((n / 2) * sizeof(float));
+    f->rev = malloc(n * sizeof(int));
+    f->tmp = malloc((size_t)n * n * sizeof(float));
+    if (!f->cos_t || !f->sin_t || !f->rev || !f->tmp) {
+        fft_free(f);
+        return -1;
+    }
+
+    for (int i = 0; i < n / 2; i++) {
+        f->cos_t[i] = (float)cos(2.0 * FFT_PI * i / n);
+        f->sin_t[i] = (float)sin(2.0 * FFT_PI * i / n);
+    }
+    for (int i = 0; i < n; i++) {
+        int r = 0;
+        for (int b = 0; b < f->log2n; b++)
+            if (i & (1 << b)) r |= 1 << (f->log2n - 1 - b);
+        f->rev[i] = r;
+    }
+    return 0;
+}
+
+void fft_free(struct Fft *f) {
+    free(f->cos_t);
+    free(f->sin_t);
+    free(f->rev);
+    free(f->tmp);
+    memset(f, 0, sizeof(*f));
+}
+
+// iterative radix 2, no scaling
+static void fft_1d_raw(const struct Fft *f, float *re, float *im, int inverse) {
+    const int n = f->n;
+    for (int i = 0; i < n; i++) {
+        int j = f->rev[i];
+        if (j > i) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    const float sign = inverse ? 1.0f : -1.0f;
+    for (int len = 2; len <= n; len <<= 1) {
+        int half = len >> 1;
+        int step = n / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < half; k++) {
+                float wr = f->cos_t[k * step];
+                float wi = sign * f->sin_t[k * step];
+                int a = start + k, b = a + half;
+                float xr = re[b] * wr - im[b] * wi;
+                float xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+void fft_1d(const struct Fft *f, float *re, float *im, int inverse) {
+    fft_1d_raw(f, re, im, inverse);
+    if (inverse) {
+        float s = 1.0f / f->n;
+        for (int i = 0; i < f->n; i++) {
+            re[i] *= s;
+            im[i] *= s;
+        }
+    }
+}
+
+struct FftRows {
+    const struct Fft *f;
+    float *re, *im;
+    int inverse;
+};
+
+static void rows_range(void *ctx, int begin, int end) {
+    struct FftRows *r = ctx;
+    for (int row = begin; row < end; row++)
+        fft_1d_raw(r->f, r->re + (size_t)row * r->f->n, r->im + (size_t)row * r->f->n, r->inverse);
+}
+
+static void transpose(float *a, float *tmp, int n) {
+    // blocked so both sides stay in cache
+    const int B = 32;
+    for (int i0 = 0; i0 < n; i0 += B)
+        for (int j0 = 0; j0 < n; j0 += B)
+            for (int i = i0; i < i0 + B && i < n; i++)
+                for (int j = j0; j < j0 + B && j < n; j++)
+                    tmp[(size_t)j * n + i] = a[(size_t)i * n + j];
+    memcpy(a, tmp, (size_t)n * n * sizeof(float));
+}
+
+void fft_2d(struct Fft *f, float *re, float *im, int inverse) {
+    const int n = f->n;
+    struct FftRows rows = {f, re, im, inverse};
+    int grain = n / (4 * parallel_thread_count()) + 1;
+
+    parallel_for(n, grain, rows_range, &rows);
+    transpose(re, f->tmp, n);
+    transpose(im, f->tmp, n);
+    parallel_for(n, grain, rows_range, &rows);
+    transpose(re, f->tmp, n);
+    transpose(im, f->tmp, n);
+
+    if (inverse) {
+        float s = 1.0f / ((float)n * n);
+        for (size_t i = 0; i < (size_t)n * n; i++) {
+            re[i] *= s;
+            im[i] *= s;
+        }
+    }
+}
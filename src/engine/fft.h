@@ -0,0 +1,21 @@
+#pragma once
+
+// in place complex fft on separate real/imag arrays, power of two sizes.
+// the inverse is scaled by 1/n (1/n^2 for 2d) so forward + inverse is identity
+
+struct Fft {
+    int n;
+    int log2n;
+    float *cos_t, *sin_t; // n/2 twiddles
+    int *rev;             // bit reversal permutation
+    float *tmp;           // n*n scratch for the 2d transpose
+};
+
+// returns -1 if n isnt a power of two or allocation failed
+int fft_init(struct Fft *f, int n);
+void fft_free(struct Fft *f);
+
+void fft_1d(const struct Fft *f, float *re, float *im, int inverse);
+
+// n x n row major, rows run in parallel
+void fft_2d(struct Fft *f, float *re, float *im, int inverse);
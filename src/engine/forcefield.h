@@ -0,0 +1,167 @@
+#pragma once
+
+#include "vec2.h"
+#include "particle.h"
+
+// declarative force fields. a sim fills a ForceFieldList once and then a
+// kernel made with FORCE_FIELD_KERNEL applies every field and integrates each
+// particle in one pass (one divide by mass, one velocity/position writeback)
+// instead of calling particle_attract/particle_drag/particle_update per particle.
+// the fields are bucketed by kind before the loop, so the loop body is one
+// short run of fields per kind with no switch.
+
+// X(KIND, name) for every field kind
+#define FORCE_FIELD_KINDS(X)        \
+    X(GRAVITY,       gravity)       \
+    X(DRAG,          drag)          \
+    X(ATTRACT,       attract)       \
+    X(PULL,          pull)          \
+    X(GRAVITY_POINT, gravity_point)
+
+enum ForceFieldKind {
+#define FORCE_FIELD_ENUM_(KIND, name) FORCE_FIELD_##KIND,
+    FORCE_FIELD_KINDS(FORCE_FIELD_ENUM_)
+#undef FORCE_FIELD_ENUM_
+    FORCE_FIELD_KIND_COUNT
+};
+
+// bit for a kind, kernels are specialized on a mask of these
+#define FORCE_FIELD_BIT(KIND) (1u << FORCE_FIELD_##KIND)
+#define FORCE_FIELD_ALL ((1u << FORCE_FIELD_KIND_COUNT) - 1u)
+
+#define FORCE_FIELDS_MAX 16
+
+struct ForceField {
+    enum ForceFieldKind kind;
+    Vec2 v;       // gravity: acceleration, everything else: the point
+    float a;      // drag: coefficient, attract/pull: strength, gravity_point: G * point_mass
+    float b;      // gravity_point: target distance
+};
+
+struct ForceFieldList {
+    struct ForceField fields[FORCE_FIELDS_MAX];
+    int count;
+};
+
+// constructors
+static inline struct ForceField force_field_gravity(Vec2 g) {
+    return (struct ForceField){FORCE_FIELD_GRAVITY, g, 0.0f, 0.0f};
+}
+
+static inline struct ForceField force_field_drag(float coefficient) {
+    return (struct ForceField){FORCE_FIELD_DRAG, vec2(0, 0), coefficient, 0.0f};
+}
+
+// same falloff as particle_attract, negative strength repels
+static inline struct ForceField force_field_attract(Vec2 point, float strength) {
+    return (struct ForceField){FORCE_FIELD_ATTRACT, point, strength, 0.0f};
+}
+
+static inline struct ForceField force_field_repel(Vec2 point, float strength) {
+    return force_field_attract(point, -strength);
+}
+
+// constant magnitude pull toward a point,
+// same as particle_attract(p, point, strength * dist)
+static inline struct ForceField force_field_pull(Vec2 point, float strength) {
+    return (struct ForceField){FORCE_FIELD_PULL, point, strength, 0.0f};
+}
+
+// same as particle_gravity_point
+static inline struct ForceField force_field_gravity_point(Vec2 point, float point_mass, float G, float target_dist) {
+    return (struct ForceField){FORCE_FIELD_GRAVITY_POINT, point, G * point_mass, target_dist};
+}
+
+// returns the field index, or -1 if the list is full
+static inline int force_fields_add(struct ForceFieldList *list, struct ForceField f) {
+    if (list->count >= FORCE_FIELDS_MAX) return -1;
+    list->fields[list->count] = f;
+    return list->count++;
+}
+
+// per kind force, everything works on squared distance so there is at most
+// one sqrt per field per particle
+static inline Vec2 force_field_eval_gravity(const struct ForceField *f, const struct Particle *p) {
+    return vec2_scale(f->v, p->mass);
+}
+
+static inline Vec2 force_field_eval_drag(const struct ForceField *f, const struct Particle *p) {
+    return vec2_scale(p->linear_velocity, -f->a);
+}
+
+static inline Vec2 force_field_eval_attract(const struct ForceField *f, const struct Particle *p) {
+    // norm(dir) * strength / dist == dir * strength / dist^2
+    Vec2 dir = vec2_sub(f->v, p->position);
+    float d2 = vec2_len2(dir);
+    if (d2 < 1e-8f) return vec2(0, 0);
+    return vec2_scale(dir, f->a / d2);
+}
+
+static inline Vec2 force_field_eval_pull(const struct ForceField *f, const struct Particle *p) {
+    Vec2 dir = vec2_sub(f->v, p->position);
+    float d2 = vec2_len2(dir);
+    if (d2 < 1e-8f) return vec2(0, 0);
+    return vec2_scale(dir, f->a / sqrtf(d2));
+}
+
+static inline Vec2 force_field_eval_gravity_point(const struct ForceField *f, const struct Particle *p) {
+    Vec2 dir = vec2_sub(f->v, p->position);
+    float d2 = vec2_len2(dir);
+    if (d2 < 1e-8f) return vec2(0, 0);
+    float dist = sqrtf(d2);
+    // G * m * M * (dist - target) / dist^2, along dir / dist
+    return vec2_scale(dir, f->a * p->mass * (dist - f->b) / (d2 * dist));
+}
+
+// the list split by kind, built once per kernel call. only kinds in the
+// mask passed to force_fields_bucket are filled
+struct ForceFieldBuckets {
+    struct ForceField fields[FORCE_FIELD_KIND_COUNT][FORCE_FIELDS_MAX];
+    int count[FORCE_FIELD_KIND_COUNT];
+};
+
+static inline void force_fields_bucket(const struct ForceFieldList *list, unsigned mask,
+                                       struct ForceFieldBuckets *b) {
+    for (int k = 0; k < FORCE_FIELD_KIND_COUNT; k++)
+        b->count[k] = 0;
+    for (int k = 0; k < list->count; k++) {
+        const struct ForceField *ff = &list->fields[k];
+        if ((unsigned)ff->kind >= FORCE_FIELD_KIND_COUNT || !(mask & (1u << ff->kind))) continue;
+        b->fields[ff->kind][b->count[ff->kind]++] = *ff;
+    }
+}
+
+// total force of the bucketed fields on p. mask is meant to be a constant
+// so the kinds that are not in it drop out
+static inline Vec2 force_fields_sum(const struct ForceFieldBuckets *b, unsigned mask, const struct Particle *p) {
+    Vec2 f = vec2(0, 0);
+#define FORCE_FIELD_SUM_(KIND, name)                                            \
+    if (mask & FORCE_FIELD_BIT(KIND)) {                                         \
+        for (int k = 0; k < b->count[FORCE_FIELD_##KIND]; k++)                  \
+            f = vec2_add(f, force_field_eval_##name(&b->fields[FORCE_FIELD_##KIND][k], p)); \
+    }
+    FORCE_FIELD_KINDS(FORCE_FIELD_SUM_)
+#undef FORCE_FIELD_SUM_
+    return f;
+}
+
+// defines `static void fn(list, particles, extra, n, dt)` that, for each
+// particle, sums the fields in mask plus extra[i] (pair forces etc, may be
+// NULL), applies it like particle_force and then does particle_update.
+// drag sees the velocity from the start of the step.
+//
+//   FORCE_FIELD_KERNEL(step_fields, FORCE_FIELD_BIT(PULL) | FORCE_FIELD_BIT(DRAG))
+#define FORCE_FIELD_KERNEL(fn, mask)                                            \
+static void fn(const struct ForceFieldList *list, struct Particle *particles,   \
+               const Vec2 *extra, int n, float dt) {                            \
+    struct ForceFieldBuckets b;                                                 \
+    force_fields_bucket(list, (mask), &b);                                      \
+    for (int i = 0; i < n; i++) {                                               \
+        struct Particle *p = &particles[i];                                     \
+        Vec2 f = force_fields_sum(&b, (mask), p);                               \
+        if (extra) f = vec2_add(f, extra[i]);                                   \
+        Vec2 v = vec2_add(p->linear_velocity, vec2_scale(f, 1.0f / p->mass));   \
+        p->linear_velocity = v;                                                 \
+        p->position = vec2_add(p->position, vec2_scale(v, dt));                 \
+    }                                                                           \
+}
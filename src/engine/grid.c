@@ -0,0 +1,88 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid.h"
+
+static int reserve(int **buf, int *capacity, int count) {
+    if (count <= *capacity) return 0;
+    int *b = realloc(*buf, count * sizeof(int));
+    if (!b) return -1;
+    *buf = b;
+    *capacity = count;
+    return 0;
+}
+
+// counting sort of the particles into the cells g already describes
+static int bin(struct CellGrid *g, const struct Particle *particles, int n) {
+    int cells = g->w * g->h;
+    if (reserve(&g->start, &g->cell_capacity, cells + 1)) return -1;
+    if (reserve(&g->items, &g->item_capacity, n)) return -1;
+
+    int *start = g->start;
+    memset(start, 0, (cells + 1) * sizeof(int));
+    for (int i = 0; i < n; i++)
+        start[cell_grid_cell(g, particles[i].position) + 1]++;
+    for (int c = 0; c < cells; c++)
+        start[c + 1] += start[c];
+    for (int i = 0; i < n; i++)
+        g->items[start[cell_grid_cell(g, particles[i].position)]++] = i;
+
+    // start[c] now points at the end of cell c, shift back
+    for (int c = cells; c > 0; c--) start[c] = start[c - 1];
+    start[0] = 0;
+    return 0;
+}
+
+int cell_grid_build(struct CellGrid *g, const struct Particle *particles, int n, float cell_size) {
+    g->w = g->h = 0;
+    if (n <= 0 || cell_size <= 0.0f) return 0;
+
+    Vec2 lo = particles[0].position, hi = lo;
+    for (int i = 1; i < n; i++) {
+        Vec2 p = particles[i].position;
+        if (p.x < lo.x) lo.x = p.x;
+        if (p.y < lo.y) lo.y = p.y;
+        if (p.x > hi.x) hi.x = p.x;
+        if (p.y > hi.y) hi.y = p.y;
+    }
+
+    float cell = cell_size;
+    while (((hi.x - lo.x) / cell + 1.0f) * ((hi.y - lo.y) / cell + 1.0f) > 4.0f * n + 16.0f)
+        cell *= 2.0f;
+
+    g->lo = lo;
+    g->cell = g->cell_h = cell;
+    g->period = vec2(0, 0);
+    g->w = (int)((hi.x - lo.x) / cell) + 1;
+    g->h = (int)((hi.y - lo.y) / cell) + 1;
+    return bin(g, particles, n);
+}
+
+int cell_grid_build_periodic(struct CellGrid *g, const struct Particle *particles, int n,
+                             float cell_size, Vec2 lo, Vec2 period) {
+    g->w = g->h = 0;
+    if (n <= 0 || cell_size <= 0.0f || period.x <= 0.0f || period.y <= 0.0f) return 0;
+
+    // whole cells so the wrap lines up, halved while too sparse
+    int w = (int)(period.x / cell_size), h = (int)(period.y / cell_size);
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+    while ((float)w * h > 4.0f * n + 16.0f && (w > 1 || h > 1)) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+
+    g->lo = lo;
+    g->period = period;
+    g->w = w;
+    g->h = h;
+    g->cell = period.x / w;
+    g->cell_h = period.y / h;
+    return bin(g, particles, n);
+}
+
+void cell_grid_free(struct CellGrid *g) {
+    free(g->start);
+    free(g->items);
+    memset(g, 0, sizeof(*g));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vec2.h"
+#include "particle.h"
+
+// uniform grid over particle positions, built with a counting sort.
+// items of cell c are items[start[c] .. start[c + 1])
+//
+// periodic grids tile a box exactly and wrap around its edges, so the
+// cells next to the right edge are neighbors of the ones on the left
+struct CellGrid {
+    Vec2 lo;
+    float cell;   // cell width
+    float cell_h; // cell height, == cell unless periodic
+    Vec2 period;  // box size of a periodic grid, (0, 0) when open
+    int w, h;
+    int *start; // w * h + 1
+    int *items; // one per particle
+    int cell_capacity, item_capacity;
+};
+
+static inline int cell_grid_cell(const struct CellGrid *g, Vec2 p) {
+    if (g->period.x > 0.0f) p = vec2_wrap(p, g->lo, g->period);
+    int cx = (int)((p.x - g->lo.x) / g->cell);
+    int cy = (int)((p.y - g->lo.y) / g->cell_h);
+    if (cx < 0) cx = 0;
+    if (cx >= g->w) cx = g->w - 1;
+    if (cy < 0) cy = 0;
+    if (cy >= g->h) cy = g->h - 1;
+    return cy * g->w + cx;
+}
+
+// cell c and the up to 8 around it, wrapped on periodic grids and each
+// listed once even when the grid is less than 3 cells across.
+// returns how many were written to out
+static inline int cell_grid_neighbors(const struct CellGrid *g, int c, int out[9]) {
+    const int periodic = g->period.x > 0.0f;
+    const int nx = periodic && g->w < 3 ? g->w : 3;
+    const int ny = periodic && g->h < 3 ? g->h : 3;
+    int cx = c % g->w, cy = c / g->w, count = 0;
+
+    for (int j = 0; j < ny; j++) {
+        int y = cy - 1 + j;
+        if (periodic) y = (y + g->h) % g->h;
+        else if (y < 0 || y >= g->h) continue;
+        for (int i = 0; i < nx; i++) {
+            int x = cx - 1 + i;
+            if (periodic) x = (x + g->w) % g->w;
+            else if (x < 0 || x >= g->w) continue;
+            out[count++] = y * g->w + x;
+        }
+    }
+    return count;
+}
+
+// bins particles into cells of at least cell_size. cells grow when the
+// grid would have more than about 4 per particle so sparse scenes stay O(n).
+// returns -1 on allocation failure
+int cell_grid_build(struct CellGrid *g, const struct Particle *particles, int n, float cell_size);
+
+// same over the periodic box [lo, lo + period), positions are wrapped
+// into it. cells are at least cell_size on both axes
+int cell_grid_build_periodic(struct CellGrid *g, const struct Particle *particles, int n,
+                             float cell_size, Vec2 lo, Vec2 period);
+void cell_grid_free(struct CellGrid *g);
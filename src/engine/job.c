@@ -0,0 +1,276 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "job.h"
+#include "parallel.h"
+
+#define JOB_MAX_WORKERS 63
+#define JOB_DEQUE_SIZE 1024 // per worker, a full deque runs the job inline
+#define JOB_SPINS 64        // idle rounds before a worker goes to sleep
+
+// ─── chase-lev deque ─────────────────────────────────────────────
+
+struct JobDeque {
+    int64_t top;    // thieves take from here
+    char pad[56];
+    int64_t bottom; // owner pushes and pops here
+    struct Job *slots[JOB_DEQUE_SIZE];
+};
+
+static int deque_push(struct JobDeque *d, struct Job *job) {
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if (b - t >= JOB_DEQUE_SIZE) return -1;
+    __atomic_store_n(&d->slots[b & (JOB_DEQUE_SIZE - 1)], job, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static struct Job *deque_pop(struct JobDeque *d) {
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        // empty
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    struct Job *job = __atomic_load_n(&d->slots[b & (JOB_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+    if (t == b) {
+        // last one, race the thieves for it
+        if (!__atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            job = NULL;
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return job;
+}
+
+static struct Job *deque_steal(struct JobDeque *d) {
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return NULL;
+
+    struct Job *job = __atomic_load_n(&d->slots[t & (JOB_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        return NULL; // lost to another thief or the owner
+    return job;
+}
+
+// ─── pool ────────────────────────────────────────────────────────
+
+struct JobInbox {
+    struct Job *slots[JOB_DEQUE_SIZE];
+    int head, count;
+};
+
+static struct {
+    struct JobDeque deques[JOB_MAX_WORKERS];
+    pthread_t threads[JOB_MAX_WORKERS];
+    int workers;
+    int running;
+
+    // submissions from threads that arent workers
+    pthread_mutex_t inbox_lock;
+    struct JobInbox inbox;
+    int inbox_count; // mirror of inbox.count readable without the lock
+
+    // sleeping
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake;
+    unsigned epoch; // bumped on every submit
+    int sleepers;
+    int quit;
+} pool = {
+    .inbox_lock = PTHREAD_MUTEX_INITIALIZER,
+    .sleep_lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+};
+
+static pthread_mutex_t pool_start_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread int job_self = -1; // worker index, -1 on other threads
+
+static void wake_workers(void) {
+    __atomic_add_fetch(&pool.epoch, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool.sleepers, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&pool.sleep_lock);
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.sleep_lock);
+    }
+}
+
+static int inbox_push(struct Job *job) {
+    pthread_mutex_lock(&pool.inbox_lock);
+    struct JobInbox *in = &pool.inbox;
+    int ok = in->count < JOB_DEQUE_SIZE;
+    if (ok) {
+        in->slots[(in->head + in->count) % JOB_DEQUE_SIZE] = job;
+        in->count++;
+        __atomic_store_n(&pool.inbox_count, in->count, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&pool.inbox_lock);
+    return ok ? 0 : -1;
+}
+
+static struct Job *inbox_pop(void) {
+    if (!__atomic_load_n(&pool.inbox_count, __ATOMIC_ACQUIRE)) return NULL;
+    struct Job *job = NULL;
+    pthread_mutex_lock(&pool.inbox_lock);
+    struct JobInbox *in = &pool.inbox;
+    if (in->count) {
+        job = in->slots[in->head];
+        in->head = (in->head + 1) % JOB_DEQUE_SIZE;
+        in->count--;
+        __atomic_store_n(&pool.inbox_count, in->count, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&pool.inbox_lock);
+    return job;
+}
+
+// own deque, then the inbox, then everyone else starting past ourselves
+static struct Job *find_job(void) {
+    struct Job *job = NULL;
+    if (job_self >= 0 && (job = deque_pop(&pool.deques[job_self]))) return job;
+    if ((job = inbox_pop())) return job;
+
+    int workers = __atomic_load_n(&pool.workers, __ATOMIC_ACQUIRE);
+    for (int k = 1; k <= workers; k++) {
+        int victim = (job_self + k + workers) % workers;
+        if (victim == job_self) continue;
+        if ((job = deque_steal(&pool.deques[victim]))) return job;
+    }
+    return NULL;
+}
+
+static void enqueue(struct Job *job);
+
+static void run_job(struct Job *job) {
+    job->fn(job->ctx);
+
+    // the job may be freed as soon as its counter drops, so read it first
+    struct JobCounter *counter = job->counter;
+    for (int i = 0; i < job->num_successors; i++) {
+        struct Job *next = job->successors[i];
+        if (__atomic_sub_fetch(&next->pending, 1, __ATOMIC_ACQ_REL) == 0)
+            enqueue(next);
+    }
+    if (counter) __atomic_sub_fetch(&counter->value, 1, __ATOMIC_RELEASE);
+}
+
+static void *worker_main(void *arg) {
+    job_self = (int)(intptr_t)arg;
+    int idle = 0;
+    for (;;) {
+        unsigned epoch = __atomic_load_n(&pool.epoch, __ATOMIC_SEQ_CST);
+        struct Job *job = find_job();
+        if (job) {
+            run_job(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < JOB_SPINS) {
+            sched_yield();
+            continue;
+        }
+
+        // nothing was submitted since epoch was read, so sleep until something is
+        pthread_mutex_lock(&pool.sleep_lock);
+        __atomic_add_fetch(&pool.sleepers, 1, __ATOMIC_SEQ_CST);
+        while (!pool.quit && __atomic_load_n(&pool.epoch, __ATOMIC_SEQ_CST) == epoch)
+            pthread_cond_wait(&pool.wake, &pool.sleep_lock);
+        __atomic_sub_fetch(&pool.sleepers, 1, __ATOMIC_SEQ_CST);
+        int quit = pool.quit;
+        pthread_mutex_unlock(&pool.sleep_lock);
+        if (quit) break;
+        idle = 0;
+    }
+    return NULL;
+}
+
+static void pool_start(void) {
+    if (__atomic_load_n(&pool.running, __ATOMIC_ACQUIRE)) return;
+    pthread_mutex_lock(&pool_start_lock);
+    if (!pool.running) {
+        int want = parallel_thread_count() - 1;
+        if (want > JOB_MAX_WORKERS) want = JOB_MAX_WORKERS;
+        pool.quit = 0;
+        int started = 0;
+        for (int i = 0; i < want; i++) {
+            memset(&pool.deques[i], 0, sizeof(pool.deques[i]));
+            if (pthread_create(&pool.threads[i], NULL, worker_main, (void *)(intptr_t)i)) break;
+            started++;
+        }
+        // a thread that failed to start just means fewer workers,
+        // job_wait still runs everything on the caller
+        __atomic_store_n(&pool.workers, started, __ATOMIC_RELEASE);
+        __atomic_store_n(&pool.running, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&pool_start_lock);
+}
+
+static void enqueue(struct Job *job) {
+    int queued = job_self >= 0 ? deque_push(&pool.deques[job_self], job) : inbox_push(job);
+    if (queued) {
+        run_job(job); // full, do it now
+        return;
+    }
+    wake_workers();
+}
+
+// ─── api ─────────────────────────────────────────────────────────
+
+void job_init(struct Job *job, JobFn fn, void *ctx) {
+    memset(job, 0, sizeof(*job));
+    job->fn = fn;
+    job->ctx = ctx;
+    job->pending = 1;
+}
+
+int job_depends(struct Job *job, struct Job *on) {
+    if (on->num_successors >= JOB_MAX_SUCCESSORS) return -1;
+    on->successors[on->num_successors++] = job;
+    job->pending++;
+    return 0;
+}
+
+void job_submit(struct Job *job, struct JobCounter *counter) {
+    pool_start();
+    job->counter = counter;
+    if (counter) __atomic_add_fetch(&counter->value, 1, __ATOMIC_RELAXED);
+    if (__atomic_sub_fetch(&job->pending, 1, __ATOMIC_ACQ_REL) == 0)
+        enqueue(job);
+}
+
+void job_wait(struct JobCounter *counter) {
+    while (__atomic_load_n(&counter->value, __ATOMIC_ACQUIRE) > 0) {
+        struct Job *job = find_job();
+        if (job) run_job(job);
+        else sched_yield();
+    }
+}
+
+int job_worker_count(void) {
+    return __atomic_load_n(&pool.workers, __ATOMIC_ACQUIRE);
+}
+
+void job_shutdown(void) {
+    pthread_mutex_lock(&pool_start_lock);
+    if (pool.running) {
+        pthread_mutex_lock(&pool.sleep_lock);
+        pool.quit = 1;
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.sleep_lock);
+        for (int i = 0; i < pool.workers; i++)
+            pthread_join(pool.threads[i], NULL);
+        __atomic_store_n(&pool.workers, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&pool.running, 0, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&pool_start_lock);
+}
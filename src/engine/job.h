@@ -0,0 +1,61 @@
+#pragma once
+
+// small work stealing job system. one worker thread per core past the
+// first, each with its own chase-lev deque: the owner pushes and pops at
+// the bottom, idle workers steal from the top. threads that arent workers
+// (the main thread) submit through a shared inbox and help run jobs while
+// they wait, so nothing ever sits blocked on a job it could run itself.
+//
+// jobs and counters are owned by the caller and must stay alive until the
+// counter they were submitted with reaches zero. a per step task graph,
+// like the one physics() in sim/particle.c builds:
+//
+//   struct Job forces, broad, narrow;
+//   struct JobCounter step = {0};
+//   job_init(&forces, forces_fn, sim);
+//   job_init(&broad, broad_fn, sim);
+//   job_init(&narrow, narrow_fn, sim);
+//   job_depends(&narrow, &broad);   // narrow runs after broad
+//   job_submit(&forces, &step);
+//   job_submit(&broad, &step);
+//   job_submit(&narrow, &step);
+//   job_wait(&step);
+//
+// data parallel loops go through parallel_for (parallel.h), which is
+// built on this.
+
+#define JOB_MAX_SUCCESSORS 8
+
+typedef void (*JobFn)(void *ctx);
+
+struct JobCounter {
+    int value; // jobs submitted with it that havent finished
+};
+
+struct Job {
+    JobFn fn;
+    void *ctx;
+    struct JobCounter *counter;
+    struct Job *successors[JOB_MAX_SUCCESSORS];
+    int num_successors;
+    int pending; // unfinished predecessors, + 1 until submitted
+};
+
+void job_init(struct Job *job, JobFn fn, void *ctx);
+
+// job wont start before `on` finished. set up every edge before submitting
+// either job. returns -1 if `on` already has JOB_MAX_SUCCESSORS
+int job_depends(struct Job *job, struct Job *on);
+
+// queue job, it runs once its predecessors are done. counter may be NULL
+void job_submit(struct Job *job, struct JobCounter *counter);
+
+// run jobs until counter reaches zero
+void job_wait(struct JobCounter *counter);
+
+// worker threads, 0 before the pool first started
+int job_worker_count(void);
+
+// stop and join the workers, the next submit starts them again with the
+// current parallel_thread_count. only call with no jobs in flight
+void job_shutdown(void);
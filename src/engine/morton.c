@@ -0,0 +1,287 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "morton.h"
+#include "parallel.h"
+
+#define MORTON_RADIX 256
+#define MORTON_MAX_BLOCKS 64
+#define MORTON_BLOCK_MIN 4096     // items per radix block
+#define MORTON_LOCALITY_SAMPLES 4096
+#define MORTON_DEFAULT_THRESHOLD 1.5f
+
+int morton_init(struct MortonSort *m, int n) {
+    memset(m, 0, sizeof(*m));
+    m->threshold = MORTON_DEFAULT_THRESHOLD;
+    if (n <= 0) return 0;
+
+    m->keys = malloc(n * sizeof(uint32_t));
+    m->keys_tmp = malloc(n * sizeof(uint32_t));
+    m->perm = malloc(n * sizeof(int));
+    m->perm_tmp = malloc(n * sizeof(int));
+    m->remap = malloc(n * sizeof(int));
+    m->ids = malloc(n * sizeof(int));
+    m->index_of = malloc(n * sizeof(int));
+    m->free_ids = malloc(n * sizeof(int));
+    if (!m->keys || !m->keys_tmp || !m->perm || !m->perm_tmp
+        || !m->remap || !m->ids || !m->index_of || !m->free_ids) {
+        morton_free(m);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        m->ids[i] = i;
+        m->index_of[i] = i;
+        m->perm[i] = i;
+        m->remap[i] = i;
+    }
+    m->capacity = n;
+    m->count = n;
+    return 0;
+}
+
+void morton_free(struct MortonSort *m) {
+    free(m->keys);
+    free(m->keys_tmp);
+    free(m->perm);
+    free(m->perm_tmp);
+    free(m->remap);
+    free(m->ids);
+    free(m->index_of);
+    free(m->free_ids);
+    free(m->scratch);
+    memset(m, 0, sizeof(*m));
+}
+
+int morton_reserve(struct MortonSort *m, int capacity) {
+    if (capacity <= m->capacity) return 0;
+    size_t n = (size_t)capacity;
+    void *tmp;
+
+    // a failed realloc leaves the old buffer in place, still valid
+#define MORTON_GROW_(ptr) \
+    if (!(tmp = realloc(ptr, n * sizeof(*(ptr))))) return -1; \
+    ptr = tmp;
+
+    MORTON_GROW_(m->keys)
+    MORTON_GROW_(m->keys_tmp)
+    MORTON_GROW_(m->perm)
+    MORTON_GROW_(m->perm_tmp)
+    MORTON_GROW_(m->remap)
+    MORTON_GROW_(m->ids)
+    MORTON_GROW_(m->index_of)
+    MORTON_GROW_(m->free_ids)
+#undef MORTON_GROW_
+
+    // ids handed out so far are exactly [0, count + num_free)
+    for (int id = m->count + m->num_free; id < capacity; id++)
+        m->index_of[id] = -1;
+    m->capacity = capacity;
+    return 0;
+}
+
+int morton_remove(struct MortonSort *m, struct Particle *particles, int n,
+                  int (*drop)(const struct Particle *p, void *ctx), void *ctx) {
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        int id = m->ids[i];
+        if (drop(&particles[i], ctx)) {
+            m->remap[i] = -1;
+            m->index_of[id] = -1;
+            m->free_ids[m->num_free++] = id;
+            continue;
+        }
+        m->remap[i] = kept;
+        m->ids[kept] = id;
+        m->index_of[id] = kept;
+        particles[kept++] = particles[i];
+    }
+    m->count = kept;
+    return kept;
+}
+
+int morton_append(struct MortonSort *m) {
+    if (m->count >= m->capacity) return -1;
+    int id = m->num_free ? m->free_ids[--m->num_free] : m->count;
+    m->ids[m->count] = id;
+    m->index_of[id] = m->count++;
+    return id;
+}
+
+float morton_locality(const struct Particle *particles, int n) {
+    if (n < 2) return 0.0f;
+    int stride = (n - 1) / MORTON_LOCALITY_SAMPLES + 1;
+    float sum = 0.0f;
+    int samples = 0;
+    for (int i = 0; i + 1 < n; i += stride) {
+        sum += vec2_dist(particles[i].position, particles[i + 1].position);
+        samples++;
+    }
+    return sum / samples;
+}
+
+// ─── parallel radix sort ─────────────────────────────────────────
+
+struct RadixPass {
+    const uint32_t *keys_in;
+    uint32_t *keys_out;
+    const int *vals_in;
+    int *vals_out;
+    int n, blocks, shift;
+    int (*hist)[MORTON_RADIX]; // per block digit counts, then offsets
+};
+
+static void block_range(const struct RadixPass *r, int b, int *begin, int *end) {
+    *begin = (int)((long)r->n * b / r->blocks);
+    *end = (int)((long)r->n * (b + 1) / r->blocks);
+}
+
+static void radix_count(void *ctx, int first, int last) {
+    struct RadixPass *r = ctx;
+    for (int b = first; b < last; b++) {
+        int begin, end;
+        block_range(r, b, &begin, &end);
+        int *h = r->hist[b];
+        memset(h, 0, MORTON_RADIX * sizeof(int));
+        for (int i = begin; i < end; i++)
+            h[(r->keys_in[i] >> r->shift) & 0xff]++;
+    }
+}
+
+static void radix_scatter(void *ctx, int first, int last) {
+    struct RadixPass *r = ctx;
+    for (int b = first; b < last; b++) {
+        int begin, end;
+        block_range(r, b, &begin, &end);
+        int *off = r->hist[b];
+        for (int i = begin; i < end; i++) {
+            uint32_t k = r->keys_in[i];
+            int dst = off[(k >> r->shift) & 0xff]++;
+            r->keys_out[dst] = k;
+            r->vals_out[dst] = r->vals_in[i];
+        }
+    }
+}
+
+// stable sort of keys with perm riding along, result ends up in keys/perm
+static int radix_sort(struct MortonSort *m, int n) {
+    int blocks = n / MORTON_BLOCK_MIN;
+    if (blocks < 1) blocks = 1;
+    if (blocks > MORTON_MAX_BLOCKS) blocks = MORTON_MAX_BLOCKS;
+
+    int (*hist)[MORTON_RADIX] = malloc(blocks * sizeof(*hist));
+    if (!hist) return -1;
+
+    uint32_t *keys = m->keys, *keys_tmp = m->keys_tmp;
+    int *vals = m->perm, *vals_tmp = m->perm_tmp;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        struct RadixPass r = {keys, keys_tmp, vals, vals_tmp, n, blocks, shift, hist};
+        parallel_for(blocks, 1, radix_count, &r);
+
+        // offsets: digit major, block minor keeps it stable
+        int sum = 0;
+        for (int d = 0; d < MORTON_RADIX; d++) {
+            for (int b = 0; b < blocks; b++) {
+                int c = hist[b][d];
+                hist[b][d] = sum;
+                sum += c;
+            }
+        }
+
+        parallel_for(blocks, 1, radix_scatter, &r);
+
+        uint32_t *tk = keys; keys = keys_tmp; keys_tmp = tk;
+        int *tv = vals; vals = vals_tmp; vals_tmp = tv;
+    }
+    // 4 passes, so keys/vals are back in the original buffers
+    free(hist);
+    return 0;
+}
+
+// ─── reorder ─────────────────────────────────────────────────────
+
+struct MortonKeys {
+    const struct Particle *particles;
+    uint32_t *keys;
+    int *perm;
+    Vec2 lo;
+    Vec2 scale;
+};
+
+static void key_range(void *ctx, int begin, int end) {
+    struct MortonKeys *k = ctx;
+    for (int i = begin; i < end; i++) {
+        Vec2 p = vec2_sub(k->particles[i].position, k->lo);
+        float fx = p.x * k->scale.x, fy = p.y * k->scale.y;
+        uint32_t x = fx <= 0.0f ? 0 : fx >= 65535.0f ? 65535 : (uint32_t)fx;
+        uint32_t y = fy <= 0.0f ? 0 : fy >= 65535.0f ? 65535 : (uint32_t)fy;
+        k->keys[i] = morton_encode(x, y);
+        k->perm[i] = i;
+    }
+}
+
+static int reserve_scratch(struct MortonSort *m, size_t size) {
+    if (size <= m->scratch_size) return 0;
+    void *s = realloc(m->scratch, size);
+    if (!s) return -1;
+    m->scratch = s;
+    m->scratch_size = size;
+    return 0;
+}
+
+int morton_apply(struct MortonSort *m, void *data, size_t elem_size) {
+    int n = m->count;
+    if (reserve_scratch(m, (size_t)n * elem_size)) return -1;
+
+    char *src = data, *dst = m->scratch;
+    for (int i = 0; i < n; i++)
+        memcpy(dst + (size_t)i * elem_size, src + (size_t)m->perm[i] * elem_size, elem_size);
+    memcpy(data, m->scratch, (size_t)n * elem_size);
+    return 0;
+}
+
+int morton_reorder(struct MortonSort *m, struct Particle *particles, int n) {
+    if (n > m->capacity) return -1;
+    m->count = n;
+    if (n < 2) return 0;
+
+    Vec2 lo = particles[0].position, hi = lo;
+    for (int i = 1; i < n; i++) {
+        Vec2 p = particles[i].position;
+        if (p.x < lo.x) lo.x = p.x;
+        if (p.y < lo.y) lo.y = p.y;
+        if (p.x > hi.x) hi.x = p.x;
+        if (p.y > hi.y) hi.y = p.y;
+    }
+    // square cell so z-order doesnt stretch along the long side
+    float extent = fmaxf(hi.x - lo.x, hi.y - lo.y);
+    float scale = extent > 0.0f ? 65535.0f / extent : 0.0f;
+
+    struct MortonKeys k = {particles, m->keys, m->perm, lo, vec2(scale, scale)};
+    parallel_for(n, MORTON_BLOCK_MIN, key_range, &k);
+
+    if (radix_sort(m, n)) return -1;
+    if (morton_apply(m, particles, sizeof(struct Particle))) return -1;
+
+    // old -> new, and keep stable ids pointing at the right slot
+    for (int i = 0; i < n; i++)
+        m->remap[m->perm[i]] = i;
+    for (int i = 0; i < n; i++)
+        m->perm_tmp[i] = m->ids[m->perm[i]];
+    for (int i = 0; i < n; i++) {
+        m->ids[i] = m->perm_tmp[i];
+        m->index_of[m->ids[i]] = i;
+    }
+
+    m->sorted_locality = m->locality = morton_locality(particles, n);
+    m->sorts++;
+    return 0;
+}
+
+int morton_maybe_reorder(struct MortonSort *m, struct Particle *particles, int n) {
+    m->locality = morton_locality(particles, n);
+    if (m->sorts > 0 && m->locality <= m->sorted_locality * m->threshold)
+        return 0;
+    return morton_reorder(m, particles, n) == 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "vec2.h"
+#include "particle.h"
+
+// keeps particle storage in z-order (morton) so particles that are close in
+// space are close in memory. sorting is a parallel lsd radix sort on 32 bit
+// keys, and only happens when measured locality got worse than right after
+// the last sort.
+//
+//   struct MortonSort m;
+//   morton_init(&m, n);
+//   ... every step
+//   if (morton_maybe_reorder(&m, particles, n)) {
+//       morton_apply(&m, my_other_array, sizeof(*my_other_array));
+//       // or remap stored indices with m.remap[old] == new
+//   }
+//
+// particles that come and go go through morton_remove / morton_append so
+// ids stay stable for the ones that stay. ids of removed particles are
+// handed out again, so ids always fit in [0, capacity).
+
+struct MortonSort {
+    uint32_t *keys, *keys_tmp;
+    int *perm, *perm_tmp; // perm[new] == old for the last reorder
+    int *remap;           // remap[old] == new for the last reorder or remove
+    int *ids;             // ids[index] == stable id
+    int *index_of;        // index_of[id] == current index, -1 if removed
+    int *free_ids;        // removed ids, reused by morton_append
+    int num_free;
+    void *scratch;        // for permuting caller arrays
+    size_t scratch_size;
+    int capacity;
+    int count;
+
+    float locality;       // last measurement, mean memory-neighbor distance
+    float sorted_locality; // measurement right after the last sort
+    float threshold;      // resort when locality > sorted_locality * threshold
+    int sorts;
+};
+
+// interleave the bits of two 16 bit coords, x in the even bits
+static inline uint32_t morton_encode(uint32_t x, uint32_t y) {
+    x &= 0xffff;
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    y &= 0xffff;
+    y = (y | (y << 8)) & 0x00ff00ff;
+    y = (y | (y << 4)) & 0x0f0f0f0f;
+    y = (y | (y << 2)) & 0x33333333;
+    y = (y | (y << 1)) & 0x55555555;
+    return x | (y << 1);
+}
+
+// ids start out as 0..n-1. returns -1 on allocation failure
+int morton_init(struct MortonSort *m, int n);
+void morton_free(struct MortonSort *m);
+
+// room for capacity particles, ids of the current ones are kept.
+// returns -1 on allocation failure
+int morton_reserve(struct MortonSort *m, int capacity);
+
+// drops the particles drop() says yes to and compacts the rest in storage
+// order. survivors keep their ids, remap[old] is the new index or -1.
+// returns the new count
+int morton_remove(struct MortonSort *m, struct Particle *particles, int n,
+                  int (*drop)(const struct Particle *p, void *ctx), void *ctx);
+
+// id for a particle appended at index count. returns -1 if at capacity
+int morton_append(struct MortonSort *m);
+
+// mean distance between particles that are next to each other in memory,
+// sampled so it stays cheap for huge n
+float morton_locality(const struct Particle *particles, int n);
+
+// always sorts. returns -1 on failure, 0 otherwise
+int morton_reorder(struct MortonSort *m, struct Particle *particles, int n);
+
+// sorts if locality degraded past the threshold, returns 1 if it did
+int morton_maybe_reorder(struct MortonSort *m, struct Particle *particles, int n);
+
+// permute another per particle array the same way the last reorder did.
+// removals dont count, use remap for those
+int morton_apply(struct MortonSort *m, void *data, size_t elem_size);
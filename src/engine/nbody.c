@@ -0,0 +1,204 @@
+#include <math.h>
+#include <string.h>
+
+#include "nbody.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NBODY_X86 1
+#endif
+
+#define NBODY_TILE 256    // 256 * 4 floats per tile side stays well inside L1
+#define NBODY_MIN_D2 1e-16f
+
+struct NbodyLaw {
+    float G, target, cutoff2;
+};
+
+// i against j in [j_begin, j_end), i's force in registers, j's written back
+static inline void pair_row_scalar(const float *x, const float *y, float *fx, float *fy,
+                                   int i, int j_begin, int j_end, struct NbodyLaw law,
+                                   float *acc_x, float *acc_y) {
+    float xi = x[i], yi = y[i];
+    float ax = 0.0f, ay = 0.0f;
+    for (int j = j_begin; j < j_end; j++) {
+        float dx = x[j] - xi, dy = y[j] - yi;
+        float d2 = dx * dx + dy * dy;
+        if (d2 > law.cutoff2 || d2 < NBODY_MIN_D2) continue;
+        float dist = sqrtf(d2);
+        float s = law.G * (dist - law.target) / dist;
+        ax += dx * s;
+        ay += dy * s;
+        fx[j] -= dx * s;
+        fy[j] -= dy * s;
+    }
+    *acc_x += ax;
+    *acc_y += ay;
+}
+
+// force on i from j in [j_begin, j_end) added to acc, nothing written to j
+static inline void row_on_scalar(const float *x, const float *y, int i, int j_begin, int j_end,
+                                 struct NbodyLaw law, float *acc_x, float *acc_y) {
+    float xi = x[i], yi = y[i];
+    float ax = 0.0f, ay = 0.0f;
+    for (int j = j_begin; j < j_end; j++) {
+        float dx = x[j] - xi, dy = y[j] - yi;
+        float d2 = dx * dx + dy * dy;
+        if (d2 > law.cutoff2 || d2 < NBODY_MIN_D2) continue;
+        float dist = sqrtf(d2);
+        float s = law.G * (dist - law.target) / dist;
+        ax += dx * s;
+        ay += dy * s;
+    }
+    *acc_x += ax;
+    *acc_y += ay;
+}
+
+static void force_on_scalar(const float *x, const float *y, int i, int n, struct NbodyLaw law,
+                            float *out_x, float *out_y) {
+    *out_x = 0.0f;
+    *out_y = 0.0f;
+    row_on_scalar(x, y, i, 0, n, law, out_x, out_y);
+}
+
+static void tile_scalar(const float *x, const float *y, float *fx, float *fy,
+                        int i0, int i1, int j0, int j1, struct NbodyLaw law) {
+    for (int i = i0; i < i1; i++) {
+        int jb = j0 > i + 1 ? j0 : i + 1; // diagonal tile only does j > i
+        float ax = 0.0f, ay = 0.0f;
+        pair_row_scalar(x, y, fx, fy, i, jb, j1, law, &ax, &ay);
+        fx[i] += ax;
+        fy[i] += ay;
+    }
+}
+
+#ifdef NBODY_X86
+__attribute__((target("avx2")))
+static float hsum256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1));
+    return _mm_cvtss_f32(lo);
+}
+
+__attribute__((target("avx2")))
+static void tile_avx2(const float *x, const float *y, float *fx, float *fy,
+                      int i0, int i1, int j0, int j1, struct NbodyLaw law) {
+    const __m256 G = _mm256_set1_ps(law.G);
+    const __m256 target = _mm256_set1_ps(law.target);
+    const __m256 cutoff2 = _mm256_set1_ps(law.cutoff2);
+    const __m256 min_d2 = _mm256_set1_ps(NBODY_MIN_D2);
+
+    for (int i = i0; i < i1; i++) {
+        int j = j0 > i + 1 ? j0 : i + 1;
+        const __m256 xi = _mm256_set1_ps(x[i]);
+        const __m256 yi = _mm256_set1_ps(y[i]);
+        __m256 ax = _mm256_setzero_ps(), ay = _mm256_setzero_ps();
+
+        for (; j + 8 <= j1; j += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), xi);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), yi);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 in = _mm256_and_ps(_mm256_cmp_ps(d2, cutoff2, _CMP_LE_OQ),
+                                      _mm256_cmp_ps(d2, min_d2, _CMP_GE_OQ));
+            if (_mm256_testz_ps(in, in)) continue;
+
+            __m256 dist = _mm256_sqrt_ps(d2);
+            __m256 s = _mm256_div_ps(_mm256_mul_ps(G, _mm256_sub_ps(dist, target)), dist);
+            s = _mm256_and_ps(s, in); // drops the masked lanes, including 0/0
+            __m256 px = _mm256_mul_ps(dx, s);
+            __m256 py = _mm256_mul_ps(dy, s);
+
+            ax = _mm256_add_ps(ax, px);
+            ay = _mm256_add_ps(ay, py);
+            _mm256_storeu_ps(fx + j, _mm256_sub_ps(_mm256_loadu_ps(fx + j), px));
+            _mm256_storeu_ps(fy + j, _mm256_sub_ps(_mm256_loadu_ps(fy + j), py));
+        }
+
+        float sx = hsum256(ax), sy = hsum256(ay);
+        pair_row_scalar(x, y, fx, fy, i, j, j1, law, &sx, &sy); // tail
+        fx[i] += sx;
+        fy[i] += sy;
+    }
+}
+
+__attribute__((target("avx2")))
+static void force_on_avx2(const float *x, const float *y, int i, int n, struct NbodyLaw law,
+                          float *out_x, float *out_y) {
+    const __m256 G = _mm256_set1_ps(law.G);
+    const __m256 target = _mm256_set1_ps(law.target);
+    const __m256 cutoff2 = _mm256_set1_ps(law.cutoff2);
+    const __m256 min_d2 = _mm256_set1_ps(NBODY_MIN_D2);
+    const __m256 xi = _mm256_set1_ps(x[i]);
+    const __m256 yi = _mm256_set1_ps(y[i]);
+    __m256 ax = _mm256_setzero_ps(), ay = _mm256_setzero_ps();
+
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), xi);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), yi);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 in = _mm256_and_ps(_mm256_cmp_ps(d2, cutoff2, _CMP_LE_OQ),
+                                  _mm256_cmp_ps(d2, min_d2, _CMP_GE_OQ));
+        if (_mm256_testz_ps(in, in)) continue;
+
+        __m256 dist = _mm256_sqrt_ps(d2);
+        __m256 s = _mm256_div_ps(_mm256_mul_ps(G, _mm256_sub_ps(dist, target)), dist);
+        s = _mm256_and_ps(s, in);
+        ax = _mm256_add_ps(ax, _mm256_mul_ps(dx, s));
+        ay = _mm256_add_ps(ay, _mm256_mul_ps(dy, s));
+    }
+
+    float sx = hsum256(ax), sy = hsum256(ay);
+    row_on_scalar(x, y, i, j, n, law, &sx, &sy); // tail
+    *out_x = sx;
+    *out_y = sy;
+}
+#endif
+
+int nbody_simd_supported(void) {
+#ifdef NBODY_X86
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return 0;
+#endif
+}
+
+void nbody_spring_forces(const float *x, const float *y, float *fx, float *fy,
+                         int n, float G, float target, float cutoff, int simd) {
+    if (n <= 0) return;
+    memset(fx, 0, n * sizeof(float));
+    memset(fy, 0, n * sizeof(float));
+
+    struct NbodyLaw law = {G, target, cutoff * cutoff};
+    void (*tile)(const float *, const float *, float *, float *, int, int, int, int, struct NbodyLaw) = tile_scalar;
+#ifdef NBODY_X86
+    if (simd && nbody_simd_supported()) tile = tile_avx2;
+#else
+    (void)simd;
+#endif
+
+    // upper triangle of tiles, each pair visited once
+    for (int i0 = 0; i0 < n; i0 += NBODY_TILE) {
+        int i1 = i0 + NBODY_TILE < n ? i0 + NBODY_TILE : n;
+        for (int j0 = i0; j0 < n; j0 += NBODY_TILE) {
+            int j1 = j0 + NBODY_TILE < n ? j0 + NBODY_TILE : n;
+            tile(x, y, fx, fy, i0, i1, j0, j1, law);
+        }
+    }
+}
+
+void nbody_spring_forces_on(const float *x, const float *y, const int *idx, int count,
+                            float *fx, float *fy, int n, float G, float target, float cutoff, int simd) {
+    struct NbodyLaw law = {G, target, cutoff * cutoff};
+    void (*force_on)(const float *, const float *, int, int, struct NbodyLaw, float *, float *) = force_on_scalar;
+#ifdef NBODY_X86
+    if (simd && nbody_simd_supported()) force_on = force_on_avx2;
+#else
+    (void)simd;
+#endif
+    for (int k = 0; k < count; k++)
+        force_on(x, y, idx[k], n, law, &fx[k], &fy[k]);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// exact all-pairs spring forces on soa positions, for scenes where the
+// interaction radius covers everything.
+//
+// for every pair closer than cutoff the force on i is
+//     d * G * (dist - target) / dist,  d = p[j] - p[i]
+// and j gets the opposite. each pair is computed once, in tiles that fit
+// in L1, with avx2 across j when simd is set and the cpu has it. simd 0
+// forces the scalar kernels, per call so sims can choose independently.
+//
+// fx/fy are overwritten, not accumulated
+void nbody_spring_forces(const float *x, const float *y, float *fx, float *fy,
+                         int n, float G, float target, float cutoff, int simd);
+
+// same law, but only the force on the particles listed in idx, from every
+// particle. fx[k], fy[k] are overwritten with the force on idx[k]. costs
+// count * n pairs, for when only a few particles need a fresh force
+void nbody_spring_forces_on(const float *x, const float *y, const int *idx, int count,
+                            float *fx, float *fy, int n, float G, float target, float cutoff, int simd);
+
+// 1 if the cpu has the avx2 path, simd = 1 only uses it then
+int nbody_simd_supported(void);
@@ -0,0 +1,88 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "neighbor.h"
+
+void neighbor_init(struct NeighborList *nl, float cutoff, float skin) {
+    memset(nl, 0, sizeof(*nl));
+    nl->cutoff = cutoff;
+    nl->skin = skin;
+}
+
+void neighbor_free(struct NeighborList *nl) {
+    free(nl->offsets);
+    free(nl->indices);
+    free(nl->built_at);
+    cell_grid_free(&nl->grid);
+    memset(nl, 0, sizeof(*nl));
+}
+
+static int push(struct NeighborList *nl, int at, int j) {
+    if (at >= nl->capacity) {
+        int cap = nl->capacity ? nl->capacity * 2 : 1024;
+        int *idx = realloc(nl->indices, cap * sizeof(int));
+        if (!idx) return -1;
+        nl->indices = idx;
+        nl->capacity = cap;
+    }
+    nl->indices[at] = j;
+    return 0;
+}
+
+int neighbor_build(struct NeighborList *nl, const struct Particle *particles, int n) {
+    nl->valid = 0;
+    if (n + 1 > nl->offsets_capacity) {
+        int *off = realloc(nl->offsets, (n + 1) * sizeof(int));
+        if (!off) return -1;
+        nl->offsets = off;
+        Vec2 *at = realloc(nl->built_at, (n > 0 ? n : 1) * sizeof(Vec2));
+        if (!at) return -1;
+        nl->built_at = at;
+        nl->offsets_capacity = n + 1;
+    }
+
+    float reach = nl->cutoff + nl->skin;
+    float reach2 = reach * reach;
+    int built = nl->period.x > 0.0f
+        ? cell_grid_build_periodic(&nl->grid, particles, n, reach, nl->lo, nl->period)
+        : cell_grid_build(&nl->grid, particles, n, reach);
+    if (built) return -1;
+    const struct CellGrid *g = &nl->grid;
+
+    int at = 0;
+    nl->offsets[0] = 0;
+    for (int i = 0; i < n; i++) {
+        Vec2 pi = particles[i].position;
+        int cells[9];
+        int num_cells = cell_grid_neighbors(g, cell_grid_cell(g, pi), cells);
+
+        for (int m = 0; m < num_cells; m++) {
+            int c = cells[m];
+            for (int k = g->start[c]; k < g->start[c + 1]; k++) {
+                int j = g->items[k];
+                if (nl->full ? j == i : j <= i) continue;
+                if (vec2_len2(vec2_sub_periodic(particles[j].position, pi, nl->period)) > reach2) continue;
+                if (push(nl, at++, j)) return -1;
+            }
+        }
+        nl->offsets[i + 1] = at;
+        nl->built_at[i] = pi;
+    }
+
+    nl->count = n;
+    nl->valid = 1;
+    nl->builds++;
+    return 0;
+}
+
+int neighbor_update(struct NeighborList *nl, const struct Particle *particles, int n) {
+    if (nl->valid && nl->count == n) {
+        // max displacement since the build against skin / 2
+        float limit = 0.25f * nl->skin * nl->skin;
+        int moved = 0;
+        for (int i = 0; i < n && !moved; i++)
+            moved = vec2_len2(vec2_sub_periodic(particles[i].position, nl->built_at[i], nl->period)) > limit;
+        if (!moved) return 0;
+    }
+    return neighbor_build(nl, particles, n) ? -1 : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "vec2.h"
+#include "particle.h"
+#include "grid.h"
+
+// verlet neighbor lists. pairs closer than cutoff + skin are stored once
+// (j > i, or both ways when full) in csr form, and the list is reused until
+// some particle moved more than skin / 2 since the build, so nothing inside
+// cutoff can be missed.
+//
+//   neighbor_update(&nl, particles, n);
+//   for (int i = 0; i < n; i++)
+//       for (int k = nl.offsets[i]; k < nl.offsets[i + 1]; k++) {
+//           int j = nl.indices[k];
+//           ... still check the real distance against cutoff
+//       }
+
+struct NeighborList {
+    float cutoff;
+    float skin;
+
+    int *offsets;  // count + 1
+    int *indices;  // offsets[count] used
+    int count;     // particles in the last build
+    int capacity;  // of indices
+    int offsets_capacity;
+
+    Vec2 *built_at; // positions at the last build
+    int valid;      // 0 forces a rebuild
+    int builds;
+
+    Vec2 lo, period; // periodic box, period (0, 0) when open
+    int full;        // every j != i, for callers that only want some rows
+
+    struct CellGrid grid;
+};
+
+void neighbor_init(struct NeighborList *nl, float cutoff, float skin);
+void neighbor_free(struct NeighborList *nl);
+
+// call when particles were reordered, added or removed
+static inline void neighbor_invalidate(struct NeighborList *nl) {
+    nl->valid = 0;
+}
+
+// pairs are found across the edges of the box [lo, lo + period) by
+// minimum image, so callers should measure them with vec2_sub_periodic.
+// cutoff + skin must stay under half the box
+static inline void neighbor_set_periodic(struct NeighborList *nl, Vec2 lo, Vec2 period) {
+    nl->lo = lo;
+    nl->period = period;
+    nl->valid = 0;
+}
+
+// always rebuild. returns -1 on allocation failure
+int neighbor_build(struct NeighborList *nl, const struct Particle *particles, int n);
+
+// lists with every neighbor of each particle, twice the memory but a row
+// alone gives the whole force on a particle
+static inline void neighbor_set_full(struct NeighborList *nl, int full) {
+    nl->full = full;
+    nl->valid = 0;
+}
+
+// rebuild only if needed. returns 1 if rebuilt, 0 if reused, -1 on failure
+int neighbor_update(struct NeighborList *nl, const struct Particle *particles, int n);
@@ -0,0 +1,71 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+
+#include "parallel.h"
+#include "job.h"
+
+#define PARALLEL_MAX_THREADS 64
+
+static int thread_override = 0;
+
+struct ParallelJob {
+    int count;
+    int grain;
+    ParallelFn fn;
+    void *ctx;
+    int next; // next unclaimed item, bumped atomically
+};
+
+// every helper keeps claiming chunks, so uneven chunks still balance
+static void parallel_claim(void *arg) {
+    struct ParallelJob *job = arg;
+    for (;;) {
+        int begin = __atomic_fetch_add(&job->next, job->grain, __ATOMIC_RELAXED);
+        if (begin >= job->count) break;
+        int end = begin + job->grain;
+        if (end > job->count) end = job->count;
+        job->fn(job->ctx, begin, end);
+    }
+}
+
+int parallel_thread_count(void) {
+    if (thread_override > 0) return thread_override;
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > PARALLEL_MAX_THREADS) n = PARALLEL_MAX_THREADS;
+    return (int)n;
+}
+
+void parallel_set_thread_count(int threads) {
+    if (threads > PARALLEL_MAX_THREADS) threads = PARALLEL_MAX_THREADS;
+    if (threads == thread_override) return;
+    thread_override = threads;
+    job_shutdown(); // restarts with the new count on the next submit
+}
+
+void parallel_for(int count, int grain, ParallelFn fn, void *ctx) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    // no point waking threads for a single chunk
+    int chunks = (count + grain - 1) / grain;
+    int helpers = parallel_thread_count();
+    if (helpers > chunks) helpers = chunks;
+    if (helpers <= 1) {
+        fn(ctx, 0, count);
+        return;
+    }
+
+    // one claiming job per extra thread, the caller claims too and then
+    // helps with whatever else is queued until its helpers are done
+    struct ParallelJob job = {count, grain, fn, ctx, 0};
+    struct Job jobs[PARALLEL_MAX_THREADS];
+    struct JobCounter done = {0};
+    for (int t = 0; t < helpers - 1; t++) {
+        job_init(&jobs[t], parallel_claim, &job);
+        job_submit(&jobs[t], &done);
+    }
+    parallel_claim(&job);
+    job_wait(&done);
+}
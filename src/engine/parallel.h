@@ -0,0 +1,17 @@
+#pragma once
+
+// fork/join helper for data parallel loops, runs on the job system (job.h).
+// fn is called with [begin, end) ranges of at most grain items until count
+// is covered, from the calling thread plus worker threads. returns after
+// every range is done. fn must be safe to run concurrently on disjoint ranges.
+// calls can nest, a waiting caller runs other queued jobs meanwhile
+typedef void (*ParallelFn)(void *ctx, int begin, int end);
+
+void parallel_for(int count, int grain, ParallelFn fn, void *ctx);
+
+// number of threads parallel_for will use (including the caller)
+int parallel_thread_count(void);
+
+// override the thread count, <= 0 goes back to one per core.
+// restarts the workers, so not while a parallel_for is running
+void parallel_set_thread_count(int threads);
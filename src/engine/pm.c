@@ -0,0 +1,234 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pm.h"
+#include "parallel.h"
+
+#define PM_PI 3.14159265358979323846
+#define PM_MAX_BLOCKS 16
+#define PM_GRAIN 1024
+
+// the 4 nodes around p and their cic weights, 0 if p is outside an
+// isolated domain
+static inline int pm_stencil(const struct PmSolver *pm, Vec2 p, int idx[4], float w[4]) {
+    float u = (p.x - pm->origin.x) / pm->cell;
+    float v = (p.y - pm->origin.y) / pm->cell;
+    float fu = floorf(u), fv = floorf(v);
+    int i0 = (int)fu, j0 = (int)fv;
+    float tx = u - fu, ty = v - fv;
+    int n = pm->size;
+
+    int i1 = i0 + 1, j1 = j0 + 1;
+    if (pm->periodic) {
+        i0 = ((i0 % n) + n) % n;
+        j0 = ((j0 % n) + n) % n;
+        i1 = (i0 + 1) % n;
+        j1 = (j0 + 1) % n;
+    } else if (i0 < 0 || j0 < 0 || i1 >= n || j1 >= n) {
+        return 0;
+    }
+
+    idx[0] = j0 * n + i0; w[0] = (1.0f - tx) * (1.0f - ty);
+    idx[1] = j0 * n + i1; w[1] = tx * (1.0f - ty);
+    idx[2] = j1 * n + i0; w[2] = (1.0f - tx) * ty;
+    idx[3] = j1 * n + i1; w[3] = tx * ty;
+    return 1;
+}
+
+static int build_green(struct PmSolver *pm) {
+    const int g = pm->grid, n = pm->size;
+    float *re = pm->green_re, *im = pm->green_im;
+
+    if (pm->periodic) {
+        // phi_k = 2 pi G m_k / laplacian eigenvalue, with the eigenvalue of
+        // the unit grid laplacian. the laplacian's 1 / cell^2 cancels the
+        // density's m / cell^2, so the cell size drops out
+        for (int q = 0; q < g; q++) {
+            for (int p = 0; p < g; p++) {
+                double lx = 2.0 * cos(2.0 * PM_PI * p / g) - 2.0;
+                double ly = 2.0 * cos(2.0 * PM_PI * q / g) - 2.0;
+                double lambda = lx + ly;
+                re[q * g + p] = (p == 0 && q == 0) ? 0.0f : (float)(2.0 * PM_PI * pm->G / lambda);
+                im[q * g + p] = 0.0f;
+            }
+        }
+        return 0;
+    }
+
+    // isolated: transform G ln r laid out with wrapped distances on the
+    // padded grid, softened by half a cell so r = 0 is finite
+    float soft2 = 0.25f * pm->cell * pm->cell;
+    for (int q = 0; q < g; q++) {
+        int dy = q < n ? q : g - q;
+        for (int p = 0; p < g; p++) {
+            int dx = p < n ? p : g - p;
+            float r2 = (dx * dx + dy * dy) * pm->cell * pm->cell + soft2;
+            re[q * g + p] = pm->G * 0.5f * logf(r2);
+            im[q * g + p] = 0.0f;
+        }
+    }
+    fft_2d(&pm->fft, re, im, 0);
+    return 0;
+}
+
+int pm_init(struct PmSolver *pm, int size, Vec2 origin, float extent, float G, int periodic) {
+    memset(pm, 0, sizeof(*pm));
+    if (size < 2 || (size & (size - 1)) || extent <= 0.0f) return -1;
+
+    pm->size = size;
+    pm->grid = periodic ? size : 2 * size;
+    pm->periodic = periodic;
+    pm->origin = origin;
+    pm->cell = extent / size;
+    pm->G = G;
+
+    pm->blocks = parallel_thread_count();
+    if (pm->blocks > PM_MAX_BLOCKS) pm->blocks = PM_MAX_BLOCKS;
+
+    size_t g2 = (size_t)pm->grid * pm->grid, n2 = (size_t)size * size;
+    if (fft_init(&pm->fft, pm->grid)) return -1;
+    pm->green_re = malloc(g2 * sizeof(float));
+    pm->green_im = malloc(g2 * sizeof(float));
+    pm->rho_re = malloc(g2 * sizeof(float));
+    pm->rho_im = malloc(g2 * sizeof(float));
+    pm->ax = malloc(n2 * sizeof(float));
+    pm->ay = malloc(n2 * sizeof(float));
+    pm->deposit = malloc(pm->blocks * n2 * sizeof(float));
+    if (!pm->green_re || !pm->green_im || !pm->rho_re || !pm->rho_im
+        || !pm->ax || !pm->ay || !pm->deposit) {
+        pm_free(pm);
+        return -1;
+    }
+
+    return build_green(pm);
+}
+
+void pm_free(struct PmSolver *pm) {
+    fft_free(&pm->fft);
+    free(pm->green_re);
+    free(pm->green_im);
+    free(pm->rho_re);
+    free(pm->rho_im);
+    free(pm->ax);
+    free(pm->ay);
+    free(pm->deposit);
+    memset(pm, 0, sizeof(*pm));
+}
+
+// ─── parallel passes ─────────────────────────────────────────────
+
+struct PmPass {
+    struct PmSolver *pm;
+    const struct Particle *particles;
+    int n;
+    Vec2 *forces;
+};
+
+// block b deposits its slice of particles into its own grid
+static void deposit_range(void *ctx, int first, int last) {
+    struct PmPass *pass = ctx;
+    struct PmSolver *pm = pass->pm;
+    size_t n2 = (size_t)pm->size * pm->size;
+
+    for (int b = first; b < last; b++) {
+        float *grid = pm->deposit + b * n2;
+        memset(grid, 0, n2 * sizeof(float));
+        int begin = (int)((long)pass->n * b / pm->blocks);
+        int end = (int)((long)pass->n * (b + 1) / pm->blocks);
+
+        for (int i = begin; i < end; i++) {
+            int idx[4];
+            float w[4];
+            if (!pm_stencil(pm, pass->particles[i].position, idx, w)) continue;
+            float m = pass->particles[i].mass;
+            for (int k = 0; k < 4; k++) grid[idx[k]] += m * w[k];
+        }
+    }
+}
+
+// sum the private grids into the (padded) fft input, row by row
+static void reduce_rows(void *ctx, int first, int last) {
+    struct PmSolver *pm = ((struct PmPass *)ctx)->pm;
+    const int n = pm->size, g = pm->grid;
+    size_t n2 = (size_t)n * n;
+
+    for (int row = first; row < last; row++) {
+        float *out = pm->rho_re + (size_t)row * g;
+        memcpy(out, pm->deposit + (size_t)row * n, n * sizeof(float));
+        for (int b = 1; b < pm->blocks; b++) {
+            const float *in = pm->deposit + b * n2 + (size_t)row * n;
+            for (int i = 0; i < n; i++) out[i] += in[i];
+        }
+    }
+}
+
+// central differences of the potential (left in rho_re) into ax/ay
+static void gradient_rows(void *ctx, int first, int last) {
+    struct PmSolver *pm = ((struct PmPass *)ctx)->pm;
+    const int n = pm->size, g = pm->grid;
+    const float *phi = pm->rho_re;
+    const float inv = 1.0f / (2.0f * pm->cell);
+
+    for (int j = first; j < last; j++) {
+        for (int i = 0; i < n; i++) {
+            int il = i - 1, ir = i + 1, jd = j - 1, ju = j + 1;
+            float sx = inv, sy = inv;
+            if (pm->periodic) {
+                il = (il + n) % n; ir %= n;
+                jd = (jd + n) % n; ju %= n;
+            } else {
+                // one sided at the edges
+                if (il < 0) { il = i; sx = 2.0f * inv; }
+                if (ir >= n) { ir = i; sx = 2.0f * inv; }
+                if (jd < 0) { jd = j; sy = 2.0f * inv; }
+                if (ju >= n) { ju = j; sy = 2.0f * inv; }
+            }
+            pm->ax[j * n + i] = -(phi[(size_t)j * g + ir] - phi[(size_t)j * g + il]) * sx;
+            pm->ay[j * n + i] = -(phi[(size_t)ju * g + i] - phi[(size_t)jd * g + i]) * sy;
+        }
+    }
+}
+
+static void interpolate_range(void *ctx, int begin, int end) {
+    struct PmPass *pass = ctx;
+    struct PmSolver *pm = pass->pm;
+
+    for (int i = begin; i < end; i++) {
+        int idx[4];
+        float w[4];
+        Vec2 a = vec2(0, 0);
+        if (pm_stencil(pm, pass->particles[i].position, idx, w)) {
+            for (int k = 0; k < 4; k++) {
+                a.x += pm->ax[idx[k]] * w[k];
+                a.y += pm->ay[idx[k]] * w[k];
+            }
+        }
+        pass->forces[i] = vec2_scale(a, pass->particles[i].mass);
+    }
+}
+
+void pm_forces(struct PmSolver *pm, const struct Particle *particles, int n, Vec2 *forces) {
+    if (n <= 0) return;
+    const int g = pm->grid;
+    size_t g2 = (size_t)g * g;
+    struct PmPass pass = {pm, particles, n, forces};
+
+    memset(pm->rho_re, 0, g2 * sizeof(float));
+    memset(pm->rho_im, 0, g2 * sizeof(float));
+    parallel_for(pm->blocks, 1, deposit_range, &pass);
+    parallel_for(pm->size, 16, reduce_rows, &pass);
+
+    // convolve with the green's function
+    fft_2d(&pm->fft, pm->rho_re, pm->rho_im, 0);
+    for (size_t k = 0; k < g2; k++) {
+        float r = pm->rho_re[k], i = pm->rho_im[k];
+        float gr = pm->green_re[k], gi = pm->green_im[k];
+        pm->rho_re[k] = r * gr - i * gi;
+        pm->rho_im[k] = r * gi + i * gr;
+    }
+    fft_2d(&pm->fft, pm->rho_re, pm->rho_im, 1);
+
+    parallel_for(pm->size, 16, gradient_rows, &pass);
+    parallel_for(n, PM_GRAIN, interpolate_range, &pass);
+}
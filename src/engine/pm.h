@@ -0,0 +1,38 @@
+#pragma once
+
+#include "vec2.h"
+#include "particle.h"
+#include "fft.h"
+
+// particle-mesh long range gravity (2d, log potential, |F| = G m1 m2 / r).
+// mass is deposited to a grid with cloud-in-cell weights, the potential is
+// solved with an fft and forces are interpolated back with the same weights.
+// cost is O(n + g^2 log g) for a g x g grid instead of O(n^2).
+//
+// isolated domains are zero padded to 2g so nothing wraps around, periodic
+// ones solve on g directly and wrap particles that leave the box.
+// isolated: particles outside the box neither deposit nor feel a force.
+
+struct PmSolver {
+    int size;      // nodes per side of the domain
+    int grid;      // fft size, 2 * size when isolated
+    int periodic;
+    Vec2 origin;
+    float cell;
+    float G;
+
+    struct Fft fft;
+    float *green_re, *green_im; // green's function in k space, grid^2
+    float *rho_re, *rho_im;     // grid^2
+    float *ax, *ay;             // node accelerations, size^2
+    float *deposit;             // one private size^2 grid per block
+    int blocks;
+};
+
+// size must be a power of two. the domain is the square [origin, origin + extent).
+// returns -1 on bad size or allocation failure
+int pm_init(struct PmSolver *pm, int size, Vec2 origin, float extent, float G, int periodic);
+void pm_free(struct PmSolver *pm);
+
+// overwrites forces[i] with the mesh force on particle i
+void pm_forces(struct PmSolver *pm, const struct Particle *particles, int n, Vec2 *forces);
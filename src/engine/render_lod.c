@@ -0,0 +1,206 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render_lod.h"
+#include "parallel.h"
+
+#define RENDER_LOD_MAX_BLOCKS 16
+#define RENDER_LOD_GRAIN 16384 // particles per block before more blocks pay off
+#define RENDER_LOD_ROWS 16     // density rows per parallel_for chunk
+
+enum { LOD_CULLED, LOD_SPLAT, LOD_CIRCLE };
+
+int render_lod_init(struct RenderLod *r, int width, int height, int texel) {
+    memset(r, 0, sizeof(*r));
+    if (width < 1 || height < 1) return -1;
+    if (texel < 1) texel = 1;
+
+    r->width = width;
+    r->height = height;
+    r->texel = texel;
+    r->grid_w = (width + texel - 1) / texel;
+    r->grid_h = (height + texel - 1) / texel;
+    r->min_radius = 1.0f;
+
+    size_t cells = (size_t)r->grid_w * r->grid_h;
+    r->density = calloc(cells, sizeof(uint32_t));
+    r->pixels = calloc(cells, sizeof(Color));
+    r->block_circles = malloc(RENDER_LOD_MAX_BLOCKS * sizeof(int));
+    r->block_splats = malloc(RENDER_LOD_MAX_BLOCKS * sizeof(int));
+    r->block_max = malloc(RENDER_LOD_MAX_BLOCKS * sizeof(uint32_t));
+    if (!r->density || !r->pixels || !r->block_circles || !r->block_splats || !r->block_max) {
+        render_lod_free(r);
+        return -1;
+    }
+    return 0;
+}
+
+void render_lod_free(struct RenderLod *r) {
+    free(r->density);
+    free(r->pixels);
+    free(r->circles);
+    free(r->kind);
+    free(r->block_circles);
+    free(r->block_splats);
+    free(r->block_max);
+    memset(r, 0, sizeof(*r));
+}
+
+static int reserve(struct RenderLod *r, int n) {
+    if (n <= r->capacity) return 0;
+    int cap = r->capacity ? r->capacity : 1024;
+    while (cap < n) cap *= 2;
+
+    int *circles = realloc(r->circles, (size_t)cap * sizeof(int));
+    if (!circles) return -1;
+    r->circles = circles;
+    uint8_t *kind = realloc(r->kind, (size_t)cap);
+    if (!kind) return -1;
+    r->kind = kind;
+    r->capacity = cap;
+    return 0;
+}
+
+// ─── parallel passes ─────────────────────────────────────────────
+
+struct LodPass {
+    struct RenderLod *r;
+    const struct Particle *particles;
+    int n;
+    Vec2 origin;
+    float scale;
+    float inv_max; // 1 / log(1 + densest cell)
+};
+
+static inline int block_begin(const struct LodPass *pass, int b) {
+    return (int)((long)pass->n * b / pass->r->blocks);
+}
+
+// cull, classify and splat one block of particles. blocks share the
+// density grid through relaxed atomic adds, private grids like pm.c uses
+// would cost a full screen clear and reduce per block every frame
+static void classify_range(void *ctx, int first, int last) {
+    struct LodPass *pass = ctx;
+    struct RenderLod *r = pass->r;
+    const float w = (float)r->width, h = (float)r->height;
+    const float inv_texel = 1.0f / r->texel;
+
+    for (int b = first; b < last; b++) {
+        int circles = 0, splats = 0;
+        uint32_t densest = 0;
+        int end = block_begin(pass, b + 1);
+
+        for (int i = block_begin(pass, b); i < end; i++) {
+            const struct Particle *p = &pass->particles[i];
+            float x = (p->position.x - pass->origin.x) * pass->scale;
+            float y = (p->position.y - pass->origin.y) * pass->scale;
+            float rad = p->radius * pass->scale;
+
+            if (rad < r->min_radius) {
+                // a dot that small only counts if its center is on screen
+                if (!(x >= 0.0f && x < w && y >= 0.0f && y < h)) {
+                    r->kind[i] = LOD_CULLED;
+                    continue;
+                }
+                int cx = (int)(x * inv_texel), cy = (int)(y * inv_texel);
+                if (cx >= r->grid_w) cx = r->grid_w - 1;
+                if (cy >= r->grid_h) cy = r->grid_h - 1;
+                uint32_t c = __atomic_add_fetch(&r->density[cy * r->grid_w + cx], 1, __ATOMIC_RELAXED);
+                if (c > densest) densest = c;
+                r->kind[i] = LOD_SPLAT;
+                splats++;
+                continue;
+            }
+
+            if (x + rad < 0.0f || x - rad > w || y + rad < 0.0f || y - rad > h) {
+                r->kind[i] = LOD_CULLED;
+                continue;
+            }
+            r->kind[i] = LOD_CIRCLE;
+            circles++;
+        }
+        r->block_circles[b] = circles;
+        r->block_splats[b] = splats;
+        r->block_max[b] = densest;
+    }
+}
+
+// block_circles holds output offsets by now
+static void gather_range(void *ctx, int first, int last) {
+    struct LodPass *pass = ctx;
+    struct RenderLod *r = pass->r;
+
+    for (int b = first; b < last; b++) {
+        int out = r->block_circles[b];
+        int end = block_begin(pass, b + 1);
+        for (int i = block_begin(pass, b); i < end; i++)
+            if (r->kind[i] == LOD_CIRCLE) r->circles[out++] = i;
+    }
+}
+
+// log scaled heat ramp, blue -> red -> yellow, transparent where empty
+static inline Color heat(float t) {
+    if (t < 0.5f) {
+        float u = t * 2.0f;
+        return (Color){(unsigned char)(40 + 180 * u), 40, (unsigned char)(160 - 120 * u),
+                       (unsigned char)(96 + 159 * t)};
+    }
+    float u = (t - 0.5f) * 2.0f;
+    return (Color){(unsigned char)(220 + 35 * u), (unsigned char)(40 + 180 * u), (unsigned char)(40 + 20 * u),
+                   (unsigned char)(96 + 159 * t)};
+}
+
+// turn counts into pixels and zero them for the next build
+static void shade_rows(void *ctx, int first, int last) {
+    struct LodPass *pass = ctx;
+    struct RenderLod *r = pass->r;
+
+    for (int row = first; row < last; row++) {
+        uint32_t *d = r->density + (size_t)row * r->grid_w;
+        Color *px = r->pixels + (size_t)row * r->grid_w;
+        for (int i = 0; i < r->grid_w; i++) {
+            if (!d[i]) {
+                px[i] = (Color){0, 0, 0, 0};
+                continue;
+            }
+            px[i] = heat(logf(1.0f + d[i]) * pass->inv_max);
+            d[i] = 0;
+        }
+    }
+}
+
+int render_lod_build(struct RenderLod *r, const struct Particle *particles, int n, Vec2 origin, float scale) {
+    r->num_circles = 0;
+    r->splatted = 0;
+    r->culled = 0;
+    if (n <= 0) return 0;
+    if (reserve(r, n)) return -1;
+
+    r->blocks = (n + RENDER_LOD_GRAIN - 1) / RENDER_LOD_GRAIN;
+    int threads = parallel_thread_count();
+    if (r->blocks > threads) r->blocks = threads;
+    if (r->blocks > RENDER_LOD_MAX_BLOCKS) r->blocks = RENDER_LOD_MAX_BLOCKS;
+
+    struct LodPass pass = {r, particles, n, origin, scale, 0.0f};
+    parallel_for(r->blocks, 1, classify_range, &pass);
+
+    // circle counts -> offsets so gather keeps storage order
+    uint32_t densest = 0;
+    for (int b = 0; b < r->blocks; b++) {
+        int c = r->block_circles[b];
+        r->block_circles[b] = r->num_circles;
+        r->num_circles += c;
+        r->splatted += r->block_splats[b];
+        if (r->block_max[b] > densest) densest = r->block_max[b];
+    }
+    parallel_for(r->blocks, 1, gather_range, &pass);
+
+    // pixels keep the last splat when nothing was splatted this time
+    if (densest) {
+        pass.inv_max = 1.0f / logf(1.0f + densest);
+        parallel_for(r->grid_h, RENDER_LOD_ROWS, shade_rows, &pass);
+    }
+    r->culled = n - r->num_circles - r->splatted;
+    return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include "vec2.h"
+#include "particle.h"
+
+// turns particles into what is worth drawing this frame. particles off the
+// view are dropped, ones smaller than min_radius pixels are counted into a
+// density grid that becomes one rgba heat texture, and only the rest are
+// left in a list of indices to draw as circles. all of it runs on
+// parallel_for and touches no gpu state, the caller uploads pixels.
+//
+//   struct RenderLod lod;
+//   render_lod_init(&lod, screen_w, screen_h, 1);
+//   ... every frame
+//   render_lod_build(&lod, particles, n, vec2(0, 0), 1.0f);
+//   if (lod.splatted) { UpdateTexture(tex, lod.pixels); DrawTextureEx(tex, .., lod.texel, WHITE); }
+//   for (int i = 0; i < lod.num_circles; i++) particle_render(&particles[lod.circles[i]]);
+
+struct RenderLod {
+    int width, height;   // view in pixels
+    int texel;           // pixels per density cell
+    int grid_w, grid_h;  // density cells
+    float min_radius;    // pixels, smaller particles are splatted
+
+    uint32_t *density;   // grid_w * grid_h counts, zero between builds
+    Color *pixels;       // grid_w * grid_h heat colors from the last build
+
+    int *circles;        // particles to draw as circles, in storage order
+    int num_circles;
+    int splatted;
+    int culled;
+
+    // scratch
+    uint8_t *kind;       // per particle classification
+    int capacity;
+    int *block_circles;  // per block circle count, then output offset
+    int *block_splats;
+    uint32_t *block_max; // per block densest cell
+    int blocks;
+};
+
+// texel < 1 is treated as 1. returns -1 on allocation failure
+int render_lod_init(struct RenderLod *r, int width, int height, int texel);
+void render_lod_free(struct RenderLod *r);
+
+// world point origin lands on pixel (0, 0), scale is pixels per world unit.
+// returns -1 if scratch for n particles cant be allocated
+int render_lod_build(struct RenderLod *r, const struct Particle *particles, int n, Vec2 origin, float scale);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+// small per-instance PRNG (pcg32) so sims dont share rand() state.
+// same seed + stream always gives the same sequence
+struct Rng {
+    uint64_t state;
+    uint64_t inc;
+};
+
+static inline uint32_t rng_next(struct Rng *r) {
+    uint64_t old = r->state;
+    r->state = old * 6364136223846793005ULL + r->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+// stream picks one of 2^63 independent sequences for the same seed
+static inline void rng_seed(struct Rng *r, uint64_t seed, uint64_t stream) {
+    r->state = 0;
+    r->inc = (stream << 1u) | 1u; // must be odd
+    rng_next(r);
+    r->state += seed;
+    rng_next(r);
+}
+
+// [0, 1)
+static inline float rng_float(struct Rng *r) {
+    return (rng_next(r) >> 8) * (1.0f / 16777216.0f);
+}
+
+// [min, max)
+static inline float rng_range(struct Rng *r, float min, float max) {
+    return min + rng_float(r) * (max - min);
+}
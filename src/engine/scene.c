@@ -0,0 +1,256 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "scene.h"
+
+static uint64_t align_up(uint64_t v) {
+    return (v + SCENE_ALIGN - 1) & ~(uint64_t)(SCENE_ALIGN - 1);
+}
+
+// the window and world are sized from this, so zero, negative and nan are out
+static int valid_extent(float width, float height) {
+    return isfinite(width) && isfinite(height) && width > 0.0f && height > 0.0f;
+}
+
+// ─── load ────────────────────────────────────────────────────────
+
+static int bind_section(struct Scene *scene, const struct SceneHeader *h, const struct SceneSection *s) {
+    char *base = scene->base;
+    uint64_t count = s->count;
+    uint32_t want_size = 0;
+    uint64_t want_count = h->num_particles;
+    void **slot = NULL;
+
+    switch (s->kind) {
+    case SCENE_POS_X:   slot = (void **)&scene->pos_x;   want_size = sizeof(float); break;
+    case SCENE_POS_Y:   slot = (void **)&scene->pos_y;   want_size = sizeof(float); break;
+    case SCENE_VEL_X:   slot = (void **)&scene->vel_x;   want_size = sizeof(float); break;
+    case SCENE_VEL_Y:   slot = (void **)&scene->vel_y;   want_size = sizeof(float); break;
+    case SCENE_MASS:    slot = (void **)&scene->mass;    want_size = sizeof(float); break;
+    case SCENE_RADIUS:  slot = (void **)&scene->radius;  want_size = sizeof(float); break;
+    case SCENE_COLOR:   slot = (void **)&scene->color;   want_size = sizeof(uint32_t); break;
+    case SCENE_LINES:   slot = (void **)&scene->lines;   want_size = sizeof(struct Line);
+                        want_count = h->num_lines; break;
+    case SCENE_SQUARES: slot = (void **)&scene->squares; want_size = sizeof(struct Square);
+                        want_count = h->num_squares; break;
+    default:
+        return 0; // newer section kinds are skipped
+    }
+
+    if (s->elem_size != want_size || count != want_count) return -1;
+    if (s->offset % SCENE_ALIGN) return -1;
+    if (s->offset > scene->size || count * s->elem_size > scene->size - s->offset) return -1;
+
+    *slot = count ? base + s->offset : NULL;
+    return 0;
+}
+
+struct Extent {
+    uint64_t begin, end;
+};
+
+static int extent_cmp(const void *a, const void *b) {
+    const struct Extent *x = a, *y = b;
+    return x->begin < y->begin ? -1 : x->begin > y->begin;
+}
+
+// no two sections share a byte, with each other or with the header and
+// the section table, and no known kind appears twice. empty sections take
+// no space. unknown kinds are bounds checked here since bind skips them
+static int check_layout(const struct Scene *scene, const struct SceneHeader *h,
+                        const struct SceneSection *sections) {
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < h->num_sections; i++) {
+        const struct SceneSection *s = &sections[i];
+        if (s->offset > scene->size) return -1;
+        if (s->elem_size && s->count > (scene->size - s->offset) / s->elem_size) return -1;
+        if (s->kind > 0 && s->kind < SCENE_SECTION_KIND_COUNT) {
+            if (seen & (1u << s->kind)) return -1;
+            seen |= 1u << s->kind;
+        }
+    }
+
+    struct Extent *ext = malloc(((size_t)h->num_sections + 2) * sizeof(struct Extent));
+    if (!ext) return -1;
+    int n = 0;
+    ext[n++] = (struct Extent){0, h->header_size};
+    ext[n++] = (struct Extent){h->section_offset,
+                               h->section_offset + (uint64_t)h->num_sections * sizeof(struct SceneSection)};
+    for (uint32_t i = 0; i < h->num_sections; i++) {
+        uint64_t size = sections[i].count * sections[i].elem_size;
+        if (size) ext[n++] = (struct Extent){sections[i].offset, sections[i].offset + size};
+    }
+
+    qsort(ext, (size_t)n, sizeof(struct Extent), extent_cmp);
+    int ok = 1;
+    for (int i = 1; i < n && ok; i++)
+        ok = ext[i].begin >= ext[i - 1].end;
+    free(ext);
+    return ok ? 0 : -1;
+}
+
+int scene_load(struct Scene *scene, const char *path) {
+    memset(scene, 0, sizeof(*scene));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st)) {
+        close(fd);
+        return -1;
+    }
+    if ((uint64_t)st.st_size < sizeof(struct SceneHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    // private + writable: callers can mutate arrays in place, pages are
+    // copied on first write and the file stays untouched
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+
+    scene->base = base;
+    scene->size = (size_t)st.st_size;
+
+    // the section table is read in place, so it has to be aligned for its
+    // uint64 fields and sit past the header
+    const struct SceneHeader *h = base;
+    if (memcmp(h->magic, SCENE_MAGIC, sizeof(h->magic)) || h->endian != SCENE_ENDIAN_TAG
+        || h->version != SCENE_VERSION
+        || h->header_size != sizeof(struct SceneHeader) || h->file_size != scene->size
+        || h->section_offset < sizeof(struct SceneHeader) || h->section_offset > scene->size
+        || h->section_offset % sizeof(uint64_t)
+        || (uint64_t)h->num_sections * sizeof(struct SceneSection) > scene->size - h->section_offset
+        || !valid_extent(h->width, h->height)) {
+        scene_unload(scene);
+        errno = EINVAL;
+        return -1;
+    }
+
+    const struct SceneSection *sections = (const void *)((char *)base + h->section_offset);
+    if (check_layout(scene, h, sections)) {
+        scene_unload(scene);
+        errno = EINVAL;
+        return -1;
+    }
+    for (uint32_t i = 0; i < h->num_sections; i++) {
+        if (bind_section(scene, h, &sections[i])) {
+            scene_unload(scene);
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    scene->num_particles = h->num_particles;
+    scene->num_lines = scene->lines ? h->num_lines : 0;
+    scene->num_squares = scene->squares ? h->num_squares : 0;
+    scene->width = h->width;
+    scene->height = h->height;
+
+    // positions are the one thing a scene cant do without
+    if (scene->num_particles && (!scene->pos_x || !scene->pos_y)) {
+        scene_unload(scene);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+void scene_unload(struct Scene *scene) {
+    if (scene->base) munmap(scene->base, scene->size);
+    memset(scene, 0, sizeof(*scene));
+}
+
+// ─── write ───────────────────────────────────────────────────────
+
+struct PendingSection {
+    uint32_t kind, elem_size;
+    uint64_t count;
+    const void *data;
+};
+
+static int write_at(FILE *f, uint64_t offset, const void *data, size_t size) {
+    if (fseeko(f, (off_t)offset, SEEK_SET)) return -1;
+    return fwrite(data, 1, size, f) == size ? 0 : -1;
+}
+
+int scene_write(const char *path, const struct SceneDesc *d) {
+    struct PendingSection pending[SCENE_SECTION_KIND_COUNT];
+    int n = 0;
+
+#define SCENE_ADD_(kind_, ptr, count_)                                       \
+    if ((ptr) && (count_))                                                   \
+        pending[n++] = (struct PendingSection){kind_, sizeof(*(ptr)), count_, ptr};
+
+    SCENE_ADD_(SCENE_POS_X, d->pos_x, d->num_particles)
+    SCENE_ADD_(SCENE_POS_Y, d->pos_y, d->num_particles)
+    SCENE_ADD_(SCENE_VEL_X, d->vel_x, d->num_particles)
+    SCENE_ADD_(SCENE_VEL_Y, d->vel_y, d->num_particles)
+    SCENE_ADD_(SCENE_MASS, d->mass, d->num_particles)
+    SCENE_ADD_(SCENE_RADIUS, d->radius, d->num_particles)
+    SCENE_ADD_(SCENE_COLOR, d->color, d->num_particles)
+    SCENE_ADD_(SCENE_LINES, d->lines, d->num_lines)
+    SCENE_ADD_(SCENE_SQUARES, d->squares, d->num_squares)
+#undef SCENE_ADD_
+
+    if ((d->num_particles && (!d->pos_x || !d->pos_y)) || !valid_extent(d->width, d->height)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    struct SceneSection table[SCENE_SECTION_KIND_COUNT];
+    uint64_t offset = align_up(sizeof(struct SceneHeader) + n * sizeof(struct SceneSection));
+    if (!n) offset = sizeof(struct SceneHeader);
+    for (int i = 0; i < n; i++) {
+        table[i] = (struct SceneSection){pending[i].kind, pending[i].elem_size, offset, pending[i].count};
+        offset = align_up(offset + pending[i].count * pending[i].elem_size);
+    }
+
+    struct SceneHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SCENE_MAGIC, sizeof(h.magic));
+    h.version = SCENE_VERSION;
+    h.header_size = sizeof(h);
+    h.file_size = offset;
+    h.num_particles = d->num_particles;
+    h.num_lines = d->lines ? d->num_lines : 0;
+    h.num_squares = d->squares ? d->num_squares : 0;
+    h.num_sections = (uint32_t)n;
+    h.section_offset = sizeof(h);
+    h.width = d->width;
+    h.height = d->height;
+    h.endian = SCENE_ENDIAN_TAG;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+
+    int err = write_at(f, 0, &h, sizeof(h))
+           || write_at(f, sizeof(h), table, n * sizeof(struct SceneSection));
+    for (int i = 0; i < n && !err; i++)
+        err = write_at(f, table[i].offset, pending[i].data, pending[i].count * pending[i].elem_size);
+
+    // pad the last section out to file_size
+    uint64_t end = n ? table[n - 1].offset + pending[n - 1].count * pending[n - 1].elem_size
+                     : sizeof(h);
+    static const char zeros[SCENE_ALIGN];
+    if (!err && end < offset)
+        err = write_at(f, end, zeros, (size_t)(offset - end));
+
+    if (fclose(f) || err) {
+        remove(path);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "primitives.h"
+
+// binary scene file, mmapped by the loader.
+//
+//   header | section table | sections...
+//
+// every section is a plain array starting on a SCENE_ALIGN boundary, so the
+// loader only validates offsets and points into the mapping, nothing is
+// copied at load. the mapping is private: writes to the arrays are
+// copy-on-write and never reach the file. the particle sim keeps its
+// particles as struct Particle records, so it still copies the soa arrays
+// out once at init (one pass over n); only code that reads the arrays
+// directly gets them without a copy. values are in the writer's byte order, and the header's endian
+// tag lets a loader on the other byte order refuse the file instead of
+// reading garbage.
+
+#define SCENE_MAGIC "PSCENE\0"
+#define SCENE_VERSION 2
+#define SCENE_ALIGN 64
+#define SCENE_ENDIAN_TAG 0x01020304u
+
+enum SceneSectionKind {
+    SCENE_POS_X = 1,   // float per particle
+    SCENE_POS_Y,
+    SCENE_VEL_X,
+    SCENE_VEL_Y,
+    SCENE_MASS,
+    SCENE_RADIUS,
+    SCENE_COLOR,       // uint32 rgba per particle
+    SCENE_LINES,       // struct Line
+    SCENE_SQUARES,     // struct Square
+    SCENE_SECTION_KIND_COUNT
+};
+
+struct SceneHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t file_size;
+    uint32_t num_particles;
+    uint32_t num_lines;
+    uint32_t num_squares;
+    uint32_t num_sections;
+    uint64_t section_offset; // section table
+    float width, height;     // world extent the scene was made for, > 0
+    uint32_t endian;         // SCENE_ENDIAN_TAG as the writer stored it
+    uint32_t reserved;
+};
+
+struct SceneSection {
+    uint32_t kind;
+    uint32_t elem_size;
+    uint64_t offset;
+    uint64_t count;
+};
+
+// a loaded scene. arrays point into the mapping, missing sections are NULL
+struct Scene {
+    void *base;
+    size_t size;
+
+    uint32_t num_particles;
+    float *pos_x, *pos_y;
+    float *vel_x, *vel_y;
+    float *mass, *radius;
+    uint32_t *color;
+
+    uint32_t num_lines, num_squares;
+    const struct Line *lines;
+    const struct Square *squares;
+
+    float width, height;
+};
+
+// same layout as struct Scene minus the mapping, for writing
+struct SceneDesc {
+    uint32_t num_particles;
+    const float *pos_x, *pos_y;
+    const float *vel_x, *vel_y;
+    const float *mass, *radius;
+    const uint32_t *color;
+
+    uint32_t num_lines, num_squares;
+    const struct Line *lines;
+    const struct Square *squares;
+
+    float width, height;
+};
+
+// returns 0 on success, -1 on io error or a malformed file (errno is EINVAL
+// for a malformed file, including one written on the other byte order)
+int scene_load(struct Scene *scene, const char *path);
+void scene_unload(struct Scene *scene);
+
+// fails with EINVAL when the extent isnt positive or positions are missing
+int scene_write(const char *path, const struct SceneDesc *desc);
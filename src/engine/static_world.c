@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "static_world.h"
+
+#define STATIC_LEAF_SIZE 4
+#define STATIC_STACK 64
+#define STATIC_RESOLVE_ITERS 4
+
+// ─── bake ────────────────────────────────────────────────────────
+
+static struct StaticShape bake_line(struct Line l, int id) {
+    struct StaticShape s = {0};
+    s.kind = STATIC_LINE;
+    s.id = id;
+    s.origin = l.start;
+    s.axis = vec2_sub(l.end, l.start);
+    s.len2 = vec2_len2(s.axis);
+    s.normal = vec2_norm(vec2(-s.axis.y, s.axis.x));
+    s.corners[0] = l.start;
+    s.corners[1] = l.end;
+    s.lo = vec2(fminf(l.start.x, l.end.x), fminf(l.start.y, l.end.y));
+    s.hi = vec2(fmaxf(l.start.x, l.end.x), fmaxf(l.start.y, l.end.y));
+    return s;
+}
+
+static struct StaticShape bake_square(struct Square q, int id) {
+    struct StaticShape s = {0};
+    s.kind = STATIC_SQUARE;
+    s.id = id;
+    s.origin = q.origin;
+    s.axis = vec2(cosf(q.rotation), sinf(q.rotation));
+    s.normal = vec2(-s.axis.y, s.axis.x);
+    s.hw = q.width * 0.5f;
+    s.hh = q.height * 0.5f;
+
+    square_get_corners(q, s.corners);
+    s.lo = s.hi = vec2_add(s.corners[0], q.origin);
+    for (int i = 0; i < 4; i++) {
+        s.corners[i] = vec2_add(s.corners[i], q.origin);
+        s.lo = vec2(fminf(s.lo.x, s.corners[i].x), fminf(s.lo.y, s.corners[i].y));
+        s.hi = vec2(fmaxf(s.hi.x, s.corners[i].x), fmaxf(s.hi.y, s.corners[i].y));
+    }
+    return s;
+}
+
+static float center_on(const struct StaticShape *s, int axis) {
+    return axis ? s->lo.y + s->hi.y : s->lo.x + s->hi.x;
+}
+
+// median split on the longest axis of the centroid bounds
+static void build_node(struct StaticWorld *w, int node, int first, int count) {
+    struct StaticShape *shapes = w->shapes;
+    struct StaticNode *nd = &w->nodes[node];
+
+    nd->lo = shapes[first].lo;
+    nd->hi = shapes[first].hi;
+    Vec2 clo = vec2_scale(vec2_add(shapes[first].lo, shapes[first].hi), 0.5f), chi = clo;
+    for (int i = first; i < first + count; i++) {
+        nd->lo = vec2(fminf(nd->lo.x, shapes[i].lo.x), fminf(nd->lo.y, shapes[i].lo.y));
+        nd->hi = vec2(fmaxf(nd->hi.x, shapes[i].hi.x), fmaxf(nd->hi.y, shapes[i].hi.y));
+        Vec2 c = vec2_scale(vec2_add(shapes[i].lo, shapes[i].hi), 0.5f);
+        clo = vec2(fminf(clo.x, c.x), fminf(clo.y, c.y));
+        chi = vec2(fmaxf(chi.x, c.x), fmaxf(chi.y, c.y));
+    }
+
+    if (count <= STATIC_LEAF_SIZE) {
+        nd->first = first;
+        nd->count = count;
+        return;
+    }
+
+    // nth_element by hand: partition around the median center
+    int axis = (chi.y - clo.y) > (chi.x - clo.x);
+    int mid = first + count / 2;
+    int lo = first, hi = first + count - 1;
+    while (lo < hi) {
+        float pivot = center_on(&shapes[(lo + hi) / 2], axis);
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (center_on(&shapes[i], axis) < pivot) i++;
+            while (center_on(&shapes[j], axis) > pivot) j--;
+            if (i <= j) {
+                struct StaticShape t = shapes[i];
+                shapes[i] = shapes[j];
+                shapes[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (mid <= j) hi = j;
+        else if (mid >= i) lo = i;
+        else break;
+    }
+
+    int left = w->num_nodes;
+    w->num_nodes += 2;
+    nd->first = left;
+    nd->count = 0;
+    build_node(w, left, first, mid - first);
+    build_node(w, left + 1, mid, first + count - mid);
+}
+
+int static_world_bake(struct StaticWorld *w, const struct Line *lines, int num_lines,
+                      const struct Square *squares, int num_squares) {
+    memset(w, 0, sizeof(*w));
+    int n = num_lines + num_squares;
+    if (n <= 0) return 0;
+
+    w->shapes = malloc(n * sizeof(struct StaticShape));
+    w->nodes = malloc(2 * n * sizeof(struct StaticNode));
+    if (!w->shapes || !w->nodes) {
+        static_world_free(w);
+        return -1;
+    }
+
+    for (int i = 0; i < num_lines; i++)
+        w->shapes[i] = bake_line(lines[i], i);
+    for (int i = 0; i < num_squares; i++)
+        w->shapes[num_lines + i] = bake_square(squares[i], i);
+    w->num_shapes = n;
+
+    w->num_nodes = 1;
+    build_node(w, 0, 0, n);
+    return 0;
+}
+
+void static_world_free(struct StaticWorld *w) {
+    free(w->nodes);
+    free(w->shapes);
+    memset(w, 0, sizeof(*w));
+}
+
+// ─── queries ─────────────────────────────────────────────────────
+
+static inline bool box_vs_circle(Vec2 lo, Vec2 hi, struct Circle c) {
+    float cx = fminf(fmaxf(c.origin.x, lo.x), hi.x);
+    float cy = fminf(fmaxf(c.origin.y, lo.y), hi.y);
+    float dx = c.origin.x - cx, dy = c.origin.y - cy;
+    return dx * dx + dy * dy <= c.radius * c.radius;
+}
+
+// vector that moves c out of s, false if they dont overlap
+static inline bool shape_vs_circle(const struct StaticShape *s, struct Circle c, Vec2 *push) {
+    if (s->kind == STATIC_LINE) {
+        Vec2 ac = vec2_sub(c.origin, s->origin);
+        float t = s->len2 > 1e-12f ? vec2_dot(ac, s->axis) / s->len2 : 0.0f;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        Vec2 d = vec2_sub(ac, vec2_scale(s->axis, t));
+        float d2 = vec2_len2(d);
+        if (d2 > c.radius * c.radius) return false;
+        float dist = sqrtf(d2);
+        Vec2 n = dist > 1e-6f ? vec2_scale(d, 1.0f / dist) : s->normal;
+        *push = vec2_scale(n, c.radius - dist);
+        return true;
+    }
+
+    // square: local space via the baked axes
+    Vec2 rel = vec2_sub(c.origin, s->origin);
+    float lx = vec2_dot(rel, s->axis), ly = vec2_dot(rel, s->normal);
+    float cx = fminf(fmaxf(lx, -s->hw), s->hw);
+    float cy = fminf(fmaxf(ly, -s->hh), s->hh);
+    float dx = lx - cx, dy = ly - cy;
+    float d2 = dx * dx + dy * dy;
+    if (d2 > c.radius * c.radius) return false;
+
+    Vec2 local;
+    if (d2 > 1e-12f) {
+        float dist = sqrtf(d2);
+        local = vec2_scale(vec2(dx, dy), (c.radius - dist) / dist);
+    } else {
+        // center inside, leave through the nearest face
+        float px = s->hw - fabsf(lx), py = s->hh - fabsf(ly);
+        if (px < py) local = vec2(lx < 0 ? -(px + c.radius) : px + c.radius, 0);
+        else local = vec2(0, ly < 0 ? -(py + c.radius) : py + c.radius);
+    }
+    *push = vec2_add(vec2_scale(s->axis, local.x), vec2_scale(s->normal, local.y));
+    return true;
+}
+
+int static_world_query_circle(const struct StaticWorld *w, struct Circle c, int *out, int max_out) {
+    if (!w->num_nodes) return 0;
+    int stack[STATIC_STACK];
+    int top = 0, hits = 0;
+    stack[top++] = 0;
+
+    while (top) {
+        const struct StaticNode *nd = &w->nodes[stack[--top]];
+        if (!box_vs_circle(nd->lo, nd->hi, c)) continue;
+        if (nd->count == 0) {
+            stack[top++] = nd->first;
+            stack[top++] = nd->first + 1;
+            continue;
+        }
+        for (int i = nd->first; i < nd->first + nd->count; i++) {
+            Vec2 push;
+            if (!box_vs_circle(w->shapes[i].lo, w->shapes[i].hi, c)) continue;
+            if (!shape_vs_circle(&w->shapes[i], c, &push)) continue;
+            if (hits < max_out) out[hits] = i;
+            hits++;
+        }
+    }
+    return hits;
+}
+
+// the shape c overlaps the most, as the push that moves it out
+static bool deepest_push(const struct StaticWorld *w, struct Circle c, Vec2 *push) {
+    int stack[STATIC_STACK];
+    int top = 0;
+    float best = -1.0f;
+    stack[top++] = 0;
+
+    while (top) {
+        const struct StaticNode *nd = &w->nodes[stack[--top]];
+        if (!box_vs_circle(nd->lo, nd->hi, c)) continue;
+        if (nd->count == 0) {
+            stack[top++] = nd->first;
+            stack[top++] = nd->first + 1;
+            continue;
+        }
+        for (int i = nd->first; i < nd->first + nd->count; i++) {
+            Vec2 p;
+            if (!box_vs_circle(w->shapes[i].lo, w->shapes[i].hi, c)) continue;
+            if (!shape_vs_circle(&w->shapes[i], c, &p)) continue;
+            float d2 = vec2_len2(p);
+            if (d2 > best) {
+                best = d2;
+                *push = p;
+            }
+        }
+    }
+    return best >= 0.0f;
+}
+
+// summing every push would double it wherever shapes share an edge
+// (a joint between collinear segments), so resolve the deepest one,
+// move, and query again. a few rounds settle corners between walls
+bool static_world_resolve_circle(const struct StaticWorld *w, struct Circle c, Vec2 *push) {
+    *push = vec2(0, 0);
+    if (!w->num_nodes) return false;
+    bool hit = false;
+
+    for (int it = 0; it < STATIC_RESOLVE_ITERS; it++) {
+        Vec2 p;
+        if (!deepest_push(w, c, &p)) break;
+        *push = vec2_add(*push, p);
+        c.origin = vec2_add(c.origin, p);
+        hit = true;
+        if (vec2_len2(p) < 1e-12f) break;
+    }
+    return hit;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include "vec2.h"
+#include "primitives.h"
+
+// static walls baked once into a flat bvh. everything the narrowphase
+// needs (corners, axes, normals, bounds) is precomputed at bake time so
+// queries never touch trig, and nothing here changes after the bake.
+
+enum StaticShapeKind {
+    STATIC_LINE,
+    STATIC_SQUARE,
+};
+
+struct StaticShape {
+    Vec2 lo, hi;       // bounds
+    Vec2 origin;       // line start / square center
+    Vec2 axis;         // line: end - start, square: local x axis (cos, sin)
+    Vec2 normal;       // line: unit normal, square: local y axis
+    Vec2 corners[4];   // square: world TL, TR, BR, BL. line: start, end
+    float hw, hh;      // square half extents
+    float len2;        // line: |end - start|^2
+    int kind;          // enum StaticShapeKind
+    int id;            // index into the lines or squares passed to the bake
+};
+
+// internal nodes have count == 0 and children at first, first + 1
+struct StaticNode {
+    Vec2 lo, hi;
+    int first;
+    int count;
+};
+
+struct StaticWorld {
+    struct StaticNode *nodes;
+    struct StaticShape *shapes;
+    int num_nodes;
+    int num_shapes;
+};
+
+// returns -1 on allocation failure
+int static_world_bake(struct StaticWorld *w, const struct Line *lines, int num_lines,
+                      const struct Square *squares, int num_squares);
+void static_world_free(struct StaticWorld *w);
+
+// indices into w->shapes of everything overlapping c, up to max_out.
+// returns the total number of hits (can be more than max_out)
+int static_world_query_circle(const struct StaticWorld *w, struct Circle c, int *out, int max_out);
+
+// vector that pushes c out of the shapes it overlaps: the deepest
+// overlap first, then again from there for a few rounds. false if it
+// overlaps nothing
+bool static_world_resolve_circle(const struct StaticWorld *w, struct Circle c, Vec2 *push);
@@ -52,6 +52,26 @@ static inline float vec2_dist(Vec2 a, Vec2 b) {
     return vec2_len(vec2_sub(a, b));
 }
 
+// a - b the short way around on periodic axes (minimum image).
+// a period of 0 leaves that axis alone
+static inline Vec2 vec2_sub_periodic(Vec2 a, Vec2 b, Vec2 period) {
+    Vec2 d = vec2_sub(a, b);
+    if (period.x > 0.0f) d.x -= period.x * rintf(d.x / period.x);
+    if (period.y > 0.0f) d.y -= period.y * rintf(d.y / period.y);
+    return d;
+}
+
+static inline float vec2_dist_periodic(Vec2 a, Vec2 b, Vec2 period) {
+    return vec2_len(vec2_sub_periodic(a, b, period));
+}
+
+// move p into [lo, lo + period) on periodic axes
+static inline Vec2 vec2_wrap(Vec2 p, Vec2 lo, Vec2 period) {
+    if (period.x > 0.0f) p.x -= period.x * floorf((p.x - lo.x) / period.x);
+    if (period.y > 0.0f) p.y -= period.y * floorf((p.y - lo.y) / period.y);
+    return p;
+}
+
 // rotate a vector by angle (radians, ccw), about the origin (0,0)
 static inline Vec2 vec2_rotate(Vec2 v, float angle) {
     float c = cosf(angle);
@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "xpbd.h"
+#include "parallel.h"
+
+#define XPBD_MAX_COLORS 64     // one bit each in used_colors
+#define XPBD_SERIAL_COLOR 64   // constraints that didnt fit any color
+#define XPBD_GRAIN 256
+
+void xpbd_init(struct XpbdSolver *s) {
+    memset(s, 0, sizeof(*s));
+    s->iterations = 4;
+}
+
+void xpbd_free(struct XpbdSolver *s) {
+    free(s->constraints);
+    free(s->order);
+    free(s->color_start);
+    free(s->prev);
+    free(s->used_colors);
+    cell_grid_free(&s->grid);
+    memset(s, 0, sizeof(*s));
+}
+
+static int reserve_constraints(struct XpbdSolver *s, int count) {
+    if (count <= s->capacity) return 0;
+    int cap = s->capacity ? s->capacity * 2 : 256;
+    while (cap < count) cap *= 2;
+
+    struct XpbdConstraint *c = realloc(s->constraints, cap * sizeof(*c));
+    if (!c) return -1;
+    s->constraints = c;
+
+    int *order = realloc(s->order, cap * sizeof(int));
+    if (!order) return -1;
+    s->order = order;
+
+    s->capacity = cap;
+    return 0;
+}
+
+static int reserve_particles(struct XpbdSolver *s, int n) {
+    if (n <= s->particle_capacity) return 0;
+    Vec2 *prev = realloc(s->prev, n * sizeof(Vec2));
+    if (!prev) return -1;
+    s->prev = prev;
+
+    uint64_t *used = realloc(s->used_colors, n * sizeof(uint64_t));
+    if (!used) return -1;
+    s->used_colors = used;
+
+    s->particle_capacity = n;
+    return 0;
+}
+
+int xpbd_add_distance(struct XpbdSolver *s, int a, int b, float rest, float compliance) {
+    if (reserve_constraints(s, s->count + 1)) return -1;
+
+    // keep distance constraints in front, move the first contact to the back
+    int idx = s->num_distance;
+    if (idx < s->count) s->constraints[s->count] = s->constraints[idx];
+    s->constraints[idx] = (struct XpbdConstraint){a, b, rest, compliance, 0.0f, XPBD_DISTANCE};
+    s->count++;
+    s->num_distance++;
+    s->colored = 0;
+    return idx;
+}
+
+void xpbd_clear_contacts(struct XpbdSolver *s) {
+    if (s->count != s->num_distance) s->colored = 0;
+    s->count = s->num_distance;
+}
+
+int xpbd_add_contact(struct XpbdSolver *s, int a, int b, float rest) {
+    if (reserve_constraints(s, s->count + 1)) return -1;
+    s->constraints[s->count] = (struct XpbdConstraint){a, b, rest, 0.0f, 0.0f, XPBD_CONTACT};
+    s->colored = 0;
+    return s->count++;
+}
+
+int xpbd_find_contacts(struct XpbdSolver *s, const struct Particle *particles, int n) {
+    xpbd_clear_contacts(s);
+    if (n < 2) return 0;
+
+    float max_r = 0.0f;
+    for (int i = 0; i < n; i++)
+        if (particles[i].radius > max_r) max_r = particles[i].radius;
+    if (max_r <= 0.0f) return 0;
+
+    struct CellGrid *g = &s->grid;
+    if (cell_grid_build(g, particles, n, 2.0f * max_r)) return -1;
+
+    for (int i = 0; i < n; i++) {
+        const struct Particle *pi = &particles[i];
+        int c0 = cell_grid_cell(g, pi->position);
+        int cx = c0 % g->w, cy = c0 / g->w;
+
+        for (int y = cy - 1; y <= cy + 1; y++) {
+            if (y < 0 || y >= g->h) continue;
+            for (int x = cx - 1; x <= cx + 1; x++) {
+                if (x < 0 || x >= g->w) continue;
+                int c = y * g->w + x;
+                for (int k = g->start[c]; k < g->start[c + 1]; k++) {
+                    int j = g->items[k];
+                    if (j <= i) continue;
+                    float rest = pi->radius + particles[j].radius;
+                    if (vec2_len2(vec2_sub(pi->position, particles[j].position)) < rest * rest &&
+                        xpbd_add_contact(s, i, j, rest) < 0) return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+void xpbd_remap(struct XpbdSolver *s, const int *remap) {
+    for (int i = 0; i < s->count; i++) {
+        s->constraints[i].a = remap[s->constraints[i].a];
+        s->constraints[i].b = remap[s->constraints[i].b];
+    }
+}
+
+int xpbd_color(struct XpbdSolver *s, int n) {
+    int counts[XPBD_MAX_COLORS + 1] = {0};
+    if (reserve_particles(s, n)) return -1;
+    if (!s->color_start) {
+        s->color_start = malloc((XPBD_MAX_COLORS + 2) * sizeof(int));
+        if (!s->color_start) return -1;
+    }
+    memset(s->used_colors, 0, n * sizeof(uint64_t));
+
+    // greedy: lowest color neither endpoint uses yet. lambda holds the
+    // color for now, it gets reset before solving anyway
+    for (int i = 0; i < s->count; i++) {
+        struct XpbdConstraint *c = &s->constraints[i];
+        uint64_t used = s->used_colors[c->a] | s->used_colors[c->b];
+        int color = XPBD_SERIAL_COLOR;
+        if (~used) {
+            color = __builtin_ctzll(~used);
+            uint64_t bit = 1ull << color;
+            s->used_colors[c->a] |= bit;
+            s->used_colors[c->b] |= bit;
+        }
+        c->lambda = (float)color;
+        counts[color]++;
+    }
+
+    // prefix sum, skip colors nobody uses
+    s->num_colors = 0;
+    s->serial_color = -1;
+    int offset = 0;
+    int slot[XPBD_MAX_COLORS + 1];
+    for (int color = 0; color <= XPBD_MAX_COLORS; color++) {
+        if (!counts[color]) continue;
+        if (color == XPBD_SERIAL_COLOR) s->serial_color = s->num_colors;
+        s->color_start[s->num_colors++] = offset;
+        slot[color] = offset;
+        offset += counts[color];
+    }
+    s->color_start[s->num_colors] = offset;
+
+    for (int i = 0; i < s->count; i++)
+        s->order[slot[(int)s->constraints[i].lambda]++] = i;
+
+    s->colored = 1;
+    return 0;
+}
+
+struct XpbdBatch {
+    struct XpbdSolver *s;
+    struct Particle *particles;
+    const int *order;
+    float inv_dt2;
+};
+
+static void solve_range(void *ctx, int begin, int end) {
+    struct XpbdBatch *b = ctx;
+    struct Particle *ps = b->particles;
+
+    for (int k = begin; k < end; k++) {
+        struct XpbdConstraint *c = &b->s->constraints[b->order[k]];
+        struct Particle *pa = &ps[c->a], *pb = &ps[c->b];
+
+        Vec2 d = vec2_sub(pa->position, pb->position);
+        float d2 = vec2_len2(d);
+        if (d2 < 1e-12f) continue;
+        float dist = sqrtf(d2);
+        float C = dist - c->rest;
+        if (c->kind == XPBD_CONTACT && C >= 0.0f) continue;
+
+        float wa = pa->mass > 0.0f ? 1.0f / pa->mass : 0.0f;
+        float wb = pb->mass > 0.0f ? 1.0f / pb->mass : 0.0f;
+        float alpha = c->compliance * b->inv_dt2;
+        float w = wa + wb + alpha;
+        if (w <= 0.0f) continue;
+
+        float dlambda = (-C - alpha * c->lambda) / w;
+        c->lambda += dlambda;
+
+        Vec2 corr = vec2_scale(d, dlambda / dist);
+        pa->position = vec2_add(pa->position, vec2_scale(corr, wa));
+        pb->position = vec2_sub(pb->position, vec2_scale(corr, wb));
+    }
+}
+
+static void bounds_range(void *ctx, int begin, int end) {
+    struct XpbdBatch *b = ctx;
+    Vec2 lo = b->s->bounds_min, hi = b->s->bounds_max;
+
+    for (int i = begin; i < end; i++) {
+        struct Particle *p = &b->particles[i];
+        float r = p->radius;
+        if (p->position.x < lo.x + r) p->position.x = lo.x + r;
+        if (p->position.x > hi.x - r) p->position.x = hi.x - r;
+        if (p->position.y < lo.y + r) p->position.y = lo.y + r;
+        if (p->position.y > hi.y - r) p->position.y = hi.y - r;
+    }
+}
+
+struct XpbdIntegrate {
+    struct XpbdSolver *s;
+    struct Particle *particles;
+    float dt;
+};
+
+static void predict_range(void *ctx, int begin, int end) {
+    struct XpbdIntegrate *in = ctx;
+    for (int i = begin; i < end; i++) {
+        struct Particle *p = &in->particles[i];
+        in->s->prev[i] = p->position;
+        p->position = vec2_add(p->position, vec2_scale(p->linear_velocity, in->dt));
+    }
+}
+
+static void velocity_range(void *ctx, int begin, int end) {
+    struct XpbdIntegrate *in = ctx;
+    float inv_dt = 1.0f / in->dt;
+    for (int i = begin; i < end; i++) {
+        struct Particle *p = &in->particles[i];
+        p->linear_velocity = vec2_scale(vec2_sub(p->position, in->s->prev[i]), inv_dt);
+    }
+}
+
+static void undo_range(void *ctx, int begin, int end) {
+    struct XpbdIntegrate *in = ctx;
+    for (int i = begin; i < end; i++)
+        in->particles[i].position = in->s->prev[i];
+}
+
+int xpbd_step(struct XpbdSolver *s, struct Particle *particles, int n, float dt) {
+    if (n <= 0 || dt <= 0.0f) return 0;
+    if (reserve_particles(s, n)) return -1;
+
+    struct XpbdIntegrate in = {s, particles, dt};
+    parallel_for(n, XPBD_GRAIN * 4, predict_range, &in);
+
+    // a partial contact set would let particles sink into each other, so
+    // back out of the whole step instead
+    if ((s->contacts && xpbd_find_contacts(s, particles, n)) ||
+        (!s->colored && xpbd_color(s, n))) {
+        parallel_for(n, XPBD_GRAIN * 4, undo_range, &in);
+        return -1;
+    }
+
+    for (int i = 0; i < s->count; i++)
+        s->constraints[i].lambda = 0.0f;
+
+    struct XpbdBatch batch = {s, particles, s->order, 1.0f / (dt * dt)};
+    for (int it = 0; it < s->iterations; it++) {
+        for (int color = 0; color < s->num_colors; color++) {
+            int begin = s->color_start[color];
+            int len = s->color_start[color + 1] - begin;
+            // the leftover color can share particles, solve it on one thread
+            int serial = color == s->serial_color;
+            batch.order = s->order + begin;
+            parallel_for(len, serial ? len : XPBD_GRAIN, solve_range, &batch);
+        }
+        if (s->bounded) parallel_for(n, XPBD_GRAIN * 4, bounds_range, &batch);
+    }
+
+    parallel_for(n, XPBD_GRAIN * 4, velocity_range, &in);
+    return 0;
+}
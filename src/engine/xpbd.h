@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include "vec2.h"
+#include "particle.h"
+#include "grid.h"
+
+// position based (xpbd) solver for particles.
+//
+// constraints are graph colored so no two constraints in a color share a
+// particle, each color is then solved with parallel_for without locks.
+// distance constraints are persistent, contacts are rebuilt every step.
+//
+//   xpbd_init(&s);
+//   xpbd_add_distance(&s, a, b, rest, compliance);  // once
+//   ... each step, after applying external forces to velocities:
+//   xpbd_step(&s, particles, n, dt);
+//   xpbd_free(&s);
+
+enum XpbdKind {
+    XPBD_DISTANCE, // |a - b| == rest
+    XPBD_CONTACT,  // |a - b| >= rest
+};
+
+struct XpbdConstraint {
+    int a, b;
+    float rest;
+    float compliance; // inverse stiffness, 0 is rigid
+    float lambda;     // accumulated over the iterations of one step
+    enum XpbdKind kind;
+};
+
+struct XpbdSolver {
+    struct XpbdConstraint *constraints;
+    int count, capacity;
+    int num_distance; // distance constraints are kept in front of contacts
+
+    // coloring, order[color_start[c] .. color_start[c + 1]) is color c
+    int *order;
+    int *color_start;
+    int num_colors;
+    int serial_color; // color that may share particles, -1 if none
+    int colored; // 0 when constraints changed since the last coloring
+
+    // per particle scratch
+    Vec2 *prev;
+    uint64_t *used_colors;
+    int particle_capacity;
+
+    struct CellGrid grid; // contact broadphase
+
+    int iterations;
+    int contacts;        // build contacts from particle radii every step
+    int bounded;         // keep particles inside bounds_min..bounds_max
+    Vec2 bounds_min, bounds_max;
+};
+
+void xpbd_init(struct XpbdSolver *s);
+void xpbd_free(struct XpbdSolver *s);
+
+// persistent constraint, returns its index or -1 on allocation failure
+int xpbd_add_distance(struct XpbdSolver *s, int a, int b, float rest, float compliance);
+
+// contacts only live until the next step rebuilds them
+void xpbd_clear_contacts(struct XpbdSolver *s);
+int xpbd_add_contact(struct XpbdSolver *s, int a, int b, float rest);
+
+// replace contacts with every overlapping pair (grid broadphase on radii).
+// returns -1 on allocation failure, contacts are then incomplete
+int xpbd_find_contacts(struct XpbdSolver *s, const struct Particle *particles, int n);
+
+// particles were reordered, remap[old] == new. colors stay valid
+void xpbd_remap(struct XpbdSolver *s, const int *remap);
+
+// greedy coloring, done by xpbd_step when needed. returns -1 on
+// allocation failure
+int xpbd_color(struct XpbdSolver *s, int n);
+
+// predict, solve, update velocities. velocities should already hold
+// external forces for this step. returns -1 if contacts or coloring ran out
+// of memory, particles are then left where they were
+int xpbd_step(struct XpbdSolver *s, struct Particle *particles, int n, float dt);
@@ -1,6 +1,5 @@
 #include <stdlib.h>
 #include <math.h>
-#include <time.h>
 
 #include "raylib.h"
 #include "particle.h"
@@ -9,86 +8,679 @@
 #include "engine/primitives.h"
 #include "engine/collision.h"
 #include "engine/particle.h"
+#include "engine/forcefield.h"
+#include "engine/rng.h"
+#include "engine/xpbd.h"
+#include "engine/morton.h"
+#include "engine/nbody.h"
+#include "engine/pm.h"
+#include "engine/neighbor.h"
+#include "engine/static_world.h"
+#include "engine/scene.h"
+#include "engine/render_lod.h"
+#include "engine/contact.h"
+#include "engine/export.h"
+#include "engine/blockstep.h"
+#include "engine/job.h"
 
-static const AppConfig *config;
-static Vec2 center;
+// below this everything fits in cache anyway
+#define MORTON_MIN_PARTICLES 2048
 
-const int NUM_PARTICLES = 200;
-const float G = 0.1f;
-const float TARGET_DIST = 120.0f;
-const float INTERACT_RADIUS = 10000.0f;
-const float RANDOM_OFFSET = 100.0f;
-struct Particle *particles;
+// verlet skin as a fraction of the interaction radius
+#define NEIGHBOR_SKIN_FRACTION 0.2f
 
-// util
-float randomFloatRange(float min, float max) {
-    float scale = (float)rand() / (float)RAND_MAX; // Range [0.0, 1.0]
-    return min + scale * (max - min);             // Range [min, max]
+// contact events kept for readers that fall behind
+#define CONTACT_RING 65536
+
+struct ParticleParams particle_params_default(void) {
+    return (struct ParticleParams){
+        .num_particles = 200,
+        .G = 0.1f,
+        .target_dist = 120.0f,
+        .interact_radius = 10000.0f,
+        .random_offset = 100.0f,
+        .drag = 0.2f,
+        .center_pull = 10.0f,
+        .solver = PARTICLE_SOLVER_FORCES,
+        .solver_iterations = 4,
+        .compliance = 1e-4f,
+        .pm_grid = 128,
+        .contacts = 0,
+        .periodic = 0,
+        .block_levels = 0,
+        .block_accuracy = 1.0f,
+        .simd = 1,
+    };
 }
 
-// main
-static void init(const AppConfig *cfg) {
-    config = cfg;
-    center = vec2((cfg->width)/2, (cfg->height)/2);
+// everything one sim instance owns
+struct ParticleSim {
+    struct ParticleParams params;
+    const AppConfig *config;
+    Vec2 center;
+    struct Rng rng;
+    struct Particle *particles;
+    int capacity; // of particles, forces and soa
+    Vec2 *forces; // pair forces accumulated per step
+    float *soa;   // x, y, fx, fy scratch for the pair kernel, n each
+    struct ForceFieldList fields;
+    struct XpbdSolver xpbd;
+    struct MortonSort morton;
+    struct PmSolver pm;
+    struct NeighborList neighbors;
+    int use_neighbors; // cutoff is small enough that lists beat all-pairs
+    Vec2 period;       // screen size when periodic, (0, 0) otherwise
+    const struct StaticWorld *world; // not owned, may be NULL
+    const struct Scene *scene;       // initial state, may be NULL
+    struct ContactEvents contacts;   // only used with params.contacts
+    struct BlockStep block;          // max_level 0 unless block steps are on
+    long force_evals;                // last step, for stats
+    long rejected;                   // commands refused so far, for stats
+    struct RenderLod lod;            // set up by the first render
+    int lod_fresh;                   // lod was built from the current particles
+    Texture2D density;               // lod heat map, needs a window so also lazy
+    struct Exporter *exporter;       // not owned, may be NULL
+    double time;                     // sim seconds, stamped on exported frames
+    float dt;                        // of the step in flight
+};
+
+// center pull + drag, fused with integration
+#define STEP_FIELDS (FORCE_FIELD_BIT(PULL) | FORCE_FIELD_BIT(DRAG))
+FORCE_FIELD_KERNEL(step_fields, STEP_FIELDS)
+
+// tie each spawn grid slot to its right and lower neighbor
+static void build_lattice(struct ParticleSim *s, int cols, float spacing_x, float spacing_y) {
+    const int n = s->params.num_particles;
+    xpbd_init(&s->xpbd);
+    s->xpbd.iterations = s->params.solver_iterations;
+    s->xpbd.contacts = 1;
+    s->xpbd.bounded = 1;
+    s->xpbd.bounds_min = vec2(0, 0);
+    s->xpbd.bounds_max = vec2(s->config->width, s->config->height);
+
+    for (int i = 0; i < n; i++) {
+        if ((i % cols) + 1 < cols && i + 1 < n)
+            xpbd_add_distance(&s->xpbd, i, i + 1, spacing_x, s->params.compliance);
+        if (i + cols < n)
+            xpbd_add_distance(&s->xpbd, i, i + cols, spacing_y, s->params.compliance);
+    }
+}
+
+// copy the scene's soa arrays into particles, missing ones get defaults.
+// the engine works on struct Particle records, so this is the one pass
+// over the mapping
+static void load_scene(struct ParticleSim *s, const struct Scene *sc) {
+    for (uint32_t i = 0; i < sc->num_particles; i++) {
+        uint32_t c = sc->color ? sc->color[i] : 0x000000ffu;
+        s->particles[i] = (struct Particle){
+            .position = vec2(sc->pos_x[i], sc->pos_y[i]),
+            .linear_velocity = sc->vel_x && sc->vel_y ? vec2(sc->vel_x[i], sc->vel_y[i]) : vec2(0, 0),
+            .mass = sc->mass ? sc->mass[i] : 1.0f,
+            .color = (Color){c >> 24, (c >> 16) & 0xff, (c >> 8) & 0xff, c & 0xff},
+            .radius = sc->radius ? sc->radius[i] : 2.0f
+        };
+    }
+}
 
-    // seed rng to current time
-    srand(time(NULL));
+// main
+static void init(void *ctx, const AppConfig *cfg) {
+    struct ParticleSim *s = ctx;
+    if (s->scene) s->params.num_particles = (int)s->scene->num_particles;
+    const struct ParticleParams *pp = &s->params;
+    const int n = pp->num_particles;
+    const float offset = pp->random_offset;
+    s->config = cfg;
+    s->center = vec2((cfg->width)/2, (cfg->height)/2);
 
     //alloc mem for particles then populate in an evenly spaced grid
-    particles = malloc(NUM_PARTICLES * sizeof(struct Particle));
+    s->particles = malloc(n * sizeof(struct Particle));
+    s->forces = malloc(n * sizeof(Vec2));
+    s->soa = malloc(4 * n * sizeof(float));
+    if (!s->particles || !s->forces || !s->soa || morton_init(&s->morton, n)) {
+        s->params.num_particles = 0; // nothing to simulate
+        return;
+    }
+    s->capacity = n;
+
+    s->fields.count = 0;
+    force_fields_add(&s->fields, force_field_pull(s->center, pp->center_pull));
+    force_fields_add(&s->fields, force_field_drag(pp->drag));
 
-    int cols = (int)ceilf(sqrtf((float)NUM_PARTICLES));
-    int rows = (int)ceilf((float)NUM_PARTICLES / cols);
+    int cols = (int)ceilf(sqrtf((float)n));
+    int rows = (int)ceilf((float)n / cols);
     float spacing_x = (float)cfg->width / (cols + 1);
     float spacing_y = (float)cfg->height / (rows + 1);
 
-    for (int i = 0; i < NUM_PARTICLES; i++) {
-        int col = i % cols;
-        int row = i / cols;
-        particles[i] = (struct Particle){
-            .position = vec2(
-                spacing_x * (col + 1) + randomFloatRange(-RANDOM_OFFSET, RANDOM_OFFSET),
-                spacing_y * (row + 1) + randomFloatRange(-RANDOM_OFFSET, RANDOM_OFFSET)
-            ),
-            .linear_velocity = vec2(0, 0),
-            .mass = 1.0f,
-            .color = BLACK,
-            .radius = 2.0f
-        };
+    if (s->scene) {
+        load_scene(s, s->scene);
+    } else {
+        for (int i = 0; i < n; i++) {
+            int col = i % cols;
+            int row = i / cols;
+            s->particles[i] = (struct Particle){
+                .position = vec2(
+                    spacing_x * (col + 1) + rng_range(&s->rng, -offset, offset),
+                    spacing_y * (row + 1) + rng_range(&s->rng, -offset, offset)
+                ),
+                .linear_velocity = vec2(0, 0),
+                .mass = 1.0f,
+                .color = BLACK,
+                .radius = 2.0f
+            };
+        }
+    }
+
+    if (pp->solver == PARTICLE_SOLVER_XPBD) {
+        build_lattice(s, cols, spacing_x, spacing_y);
+        s->params.periodic = 0; // the solver keeps particles inside walls
+    }
+
+    // on a torus pairs only see their nearest image, and the lists always
+    // beat all-pairs since nothing interacts past half the screen
+    s->period = vec2(0, 0);
+    if (pp->periodic) {
+        s->period = vec2(cfg->width, cfg->height);
+        float half = 0.5f * fminf(s->period.x, s->period.y) / (1.0f + NEIGHBOR_SKIN_FRACTION);
+        if (s->params.interact_radius > half) s->params.interact_radius = half;
+    }
+
+    neighbor_init(&s->neighbors, pp->interact_radius, pp->interact_radius * NEIGHBOR_SKIN_FRACTION);
+    neighbor_set_periodic(&s->neighbors, vec2(0, 0), s->period);
+    s->use_neighbors = pp->periodic || pp->interact_radius < 0.5f * fmaxf(cfg->width, cfg->height);
+
+    if (pp->contacts && contact_events_init(&s->contacts, CONTACT_RING))
+        s->params.contacts = 0;
+    s->contacts.period = s->period;
+
+    // mesh covers twice the screen around the center, or exactly the
+    // screen when it wraps (the periodic solver needs a square box)
+    if (pp->solver == PARTICLE_SOLVER_PM) {
+        int periodic = pp->periodic && cfg->width == cfg->height;
+        float extent = periodic ? (float)cfg->width : 2.0f * fmaxf(cfg->width, cfg->height);
+        Vec2 origin = periodic ? vec2(0, 0) : vec2_sub(s->center, vec2(extent * 0.5f, extent * 0.5f));
+        if ((pp->periodic && !periodic) || pm_init(&s->pm, pp->pm_grid, origin, extent, pp->G, periodic))
+            s->params.solver = PARTICLE_SOLVER_FORCES;
+    }
+
+    // the mesh and the lattice solve everyone at once, so only pair forces
+    // gain from skipping particles. rows of a full list are whole forces
+    if (pp->solver != PARTICLE_SOLVER_FORCES) s->params.block_levels = 0;
+    blockstep_init(&s->block, pp->block_levels, pp->block_accuracy);
+    if (s->block.max_level > 0) neighbor_set_full(&s->neighbors, 1);
+}
+
+// external forces only, the solver moves the particles
+static void physics_xpbd(struct ParticleSim *s, float dt) {
+    const int n = s->params.num_particles;
+    struct ForceFieldBuckets fields;
+    force_fields_bucket(&s->fields, STEP_FIELDS, &fields);
+    for (int i = 0; i < n; i++) {
+        struct Particle *p = &s->particles[i];
+        Vec2 f = force_fields_sum(&fields, STEP_FIELDS, p);
+        p->linear_velocity = vec2_add(p->linear_velocity, vec2_scale(f, 1.0f / p->mass));
+    }
+    // out of memory, drift unconstrained rather than freeze
+    if (xpbd_step(&s->xpbd, s->particles, n, dt)) {
+        for (int i = 0; i < n; i++)
+            particle_update(&s->particles[i], dt);
+    }
+}
+
+// same spring law as nbody_spring_forces, streaming the verlet lists
+static void pair_forces_neighbors(struct ParticleSim *s) {
+    const struct ParticleParams *pp = &s->params;
+    const struct NeighborList *nl = &s->neighbors;
+    const struct Particle *particles = s->particles;
+    Vec2 *forces = s->forces;
+    const int n = pp->num_particles;
+    const float r2_max = pp->interact_radius * pp->interact_radius;
+
+    for (int i = 0; i < n; i++)
+        forces[i] = vec2(0, 0);
+
+    for (int i = 0; i < n; i++) {
+        Vec2 pi = particles[i].position;
+        Vec2 fi = vec2(0, 0);
+        for (int k = nl->offsets[i]; k < nl->offsets[i + 1]; k++) {
+            int j = nl->indices[k];
+            if (j < i) continue; // full lists have every pair twice
+            Vec2 d = vec2_sub_periodic(particles[j].position, pi, s->period);
+            float d2 = vec2_len2(d);
+            if (d2 > r2_max || d2 < 1e-16f) continue;
+            float dist = sqrtf(d2);
+            Vec2 f = vec2_scale(d, pp->G * (dist - pp->target_dist) / dist);
+            fi = vec2_add(fi, f);
+            forces[j] = vec2_sub(forces[j], f);
+        }
+        forces[i] = vec2_add(forces[i], fi);
+    }
+}
+
+// all pairs, tiled kernel on soa copies of the positions
+static void pair_forces_all(struct ParticleSim *s) {
+    const struct ParticleParams *pp = &s->params;
+    const int n = pp->num_particles;
+    float *x = s->soa, *y = x + n, *fx = y + n, *fy = fx + n;
+
+    for (int i = 0; i < n; i++) {
+        x[i] = s->particles[i].position.x;
+        y[i] = s->particles[i].position.y;
+    }
+    nbody_spring_forces(x, y, fx, fy, n, pp->G, pp->target_dist, pp->interact_radius, pp->simd);
+    for (int i = 0; i < n; i++)
+        s->forces[i] = vec2(fx[i], fy[i]);
+}
+
+// forces[k] = pair force on active[k] alone. the symmetric kernels are
+// cheaper once everything is active
+static void pair_forces_active(struct ParticleSim *s, const int *active, int count) {
+    const struct ParticleParams *pp = &s->params;
+    const struct Particle *particles = s->particles;
+    const int n = pp->num_particles;
+
+    if (s->use_neighbors && neighbor_update(&s->neighbors, particles, n) >= 0) {
+        if (count == n) {
+            pair_forces_neighbors(s);
+            return;
+        }
+        const struct NeighborList *nl = &s->neighbors;
+        const float r2_max = pp->interact_radius * pp->interact_radius;
+        for (int k = 0; k < count; k++) {
+            int i = active[k];
+            Vec2 pi = particles[i].position;
+            Vec2 fi = vec2(0, 0);
+            for (int m = nl->offsets[i]; m < nl->offsets[i + 1]; m++) {
+                Vec2 d = vec2_sub_periodic(particles[nl->indices[m]].position, pi, s->period);
+                float d2 = vec2_len2(d);
+                if (d2 > r2_max || d2 < 1e-16f) continue;
+                float dist = sqrtf(d2);
+                fi = vec2_add(fi, vec2_scale(d, pp->G * (dist - pp->target_dist) / dist));
+            }
+            s->forces[k] = fi;
+        }
+        return;
+    }
+
+    if (count == n) {
+        pair_forces_all(s);
+        return;
+    }
+    float *x = s->soa, *y = x + n, *fx = y + n, *fy = fx + n;
+    for (int i = 0; i < n; i++) {
+        x[i] = particles[i].position.x;
+        y[i] = particles[i].position.y;
+    }
+    nbody_spring_forces_on(x, y, active, count, fx, fy, n, pp->G, pp->target_dist, pp->interact_radius, pp->simd);
+    for (int k = 0; k < count; k++)
+        s->forces[k] = vec2(fx[k], fy[k]);
+}
+
+// hierarchical block steps, see engine/blockstep.h. each substep finds the
+// forces on the active particles only and kicks them over their own step,
+// then drifts everyone over the substep. a kick of f / m is one whole dt,
+// same as step_fields
+static void physics_block(struct ParticleSim *s, float dt) {
+    struct BlockStep *b = &s->block;
+    struct Particle *particles = s->particles;
+    const int n = s->params.num_particles;
+    const int substeps = blockstep_substeps(b);
+    const float h = dt / substeps;
+    struct ForceFieldBuckets fields;
+    force_fields_bucket(&s->fields, STEP_FIELDS, &fields);
+
+    b->evaluations = 0;
+    for (int sub = 0; sub < substeps; sub++) {
+        int count = blockstep_gather(b, sub, n);
+        pair_forces_active(s, b->active, count);
+
+        for (int k = 0; k < count; k++) {
+            int i = b->active[k];
+            struct Particle *p = &particles[i];
+            Vec2 f = vec2_add(s->forces[k], force_fields_sum(&fields, STEP_FIELDS, p));
+            Vec2 kick = vec2_scale(f, 1.0f / p->mass);
+            int level = blockstep_choose(b, i, sub, vec2_len(kick) / dt, vec2_len(p->linear_velocity), dt);
+            p->linear_velocity = vec2_add(p->linear_velocity, vec2_scale(kick, blockstep_fraction(level)));
+        }
+
+        for (int i = 0; i < n; i++)
+            particles[i].position = vec2_add(particles[i].position, vec2_scale(particles[i].linear_velocity, h));
+    }
+    s->force_evals = b->evaluations;
+}
+
+// push particles out of static walls and drop the velocity into them
+static void collide_world(struct ParticleSim *s) {
+    for (int i = 0; i < s->params.num_particles; i++) {
+        struct Particle *p = &s->particles[i];
+        Vec2 push;
+        if (!static_world_resolve_circle(s->world, (struct Circle){p->position, p->radius}, &push))
+            continue;
+        p->position = vec2_add(p->position, push);
+        float len2 = vec2_len2(push);
+        if (len2 < 1e-12f) continue;
+        Vec2 n = vec2_scale(push, 1.0f / sqrtf(len2));
+        float vn = vec2_dot(p->linear_velocity, n);
+        if (vn < 0.0f) p->linear_velocity = vec2_sub(p->linear_velocity, vec2_scale(n, vn));
+    }
+}
+
+// moves the particles: reorder, forces, integrate, walls, wrap
+static void step_particles(void *ctx) {
+    struct ParticleSim *s = ctx;
+    struct Particle *particles = s->particles;
+    const struct ParticleParams *pp = &s->params;
+    const int n = pp->num_particles;
+    const float dt = s->dt;
+
+    // keep spatial neighbors close in memory
+    if (n >= MORTON_MIN_PARTICLES && morton_maybe_reorder(&s->morton, particles, n) > 0) {
+        neighbor_invalidate(&s->neighbors);
+        if (pp->solver == PARTICLE_SOLVER_XPBD)
+            xpbd_remap(&s->xpbd, s->morton.remap);
+    }
+
+    s->force_evals = n;
+    if (pp->solver == PARTICLE_SOLVER_XPBD) {
+        physics_xpbd(s, dt);
+    } else if (s->block.max_level > 0 && blockstep_reserve(&s->block, n) == 0) {
+        physics_block(s, dt);
+    } else {
+        if (pp->solver == PARTICLE_SOLVER_PM)
+            pm_forces(&s->pm, particles, n, s->forces);
+        else if (s->use_neighbors && neighbor_update(&s->neighbors, particles, n) >= 0)
+            pair_forces_neighbors(s);
+        else
+            pair_forces_all(s);
+
+        // fields + integrate in one pass
+        step_fields(&s->fields, particles, s->forces, n, dt);
+    }
+
+    if (s->world) collide_world(s);
+    if (pp->periodic) {
+        for (int i = 0; i < n; i++)
+            particles[i].position = vec2_wrap(particles[i].position, vec2(0, 0), s->period);
     }
 }
 
-static void physics(float dt) {
-    // pairwise gravity (only within interaction radius)
-    for (int i = 0; i < NUM_PARTICLES; i++) {
-        for (int j = i + 1; j < NUM_PARTICLES; j++) {
-            float dist = vec2_dist(particles[i].position, particles[j].position);
-            if (dist > INTERACT_RADIUS) continue;
-            Vec2 dir = vec2_norm(vec2_sub(particles[j].position, particles[i].position));
-            float force = (dist - TARGET_DIST) * G;
-            Vec2 f = vec2_scale(dir, force);
-            particle_force(&particles[i], f);
-            particle_force(&particles[j], vec2_scale(f, 0.0f));
+// the rest of the step only reads the particles, so it runs side by side
+
+static void find_contacts(void *ctx) {
+    struct ParticleSim *s = ctx;
+    const int n = s->params.num_particles;
+    contact_events_clear(&s->contacts);
+    contact_find_particles(&s->contacts, s->particles, s->morton.ids, n);
+    if (s->world) contact_find_world(&s->contacts, s->world, s->particles, s->morton.ids, n);
+    contact_events_commit(&s->contacts);
+}
+
+// cpu half of the render lod, render only uploads and draws it
+static void prep_render(void *ctx) {
+    struct ParticleSim *s = ctx;
+    s->lod_fresh = render_lod_build(&s->lod, s->particles, s->params.num_particles, vec2(0, 0), 1.0f) == 0;
+}
+
+static void publish(void *ctx) {
+    struct ParticleSim *s = ctx;
+    export_publish(s->exporter, s->particles, s->params.num_particles, s->time);
+}
+
+// one task graph per step, everything after step_particles depends on it.
+// render prep only starts once render has set up the lod, so headless
+// runs dont pay for it
+static void physics(void *ctx, float dt) {
+    struct ParticleSim *s = ctx;
+    struct Job step, contacts, lod, exporting;
+    struct JobCounter done = {0};
+
+    s->dt = dt;
+    s->time += dt;
+    s->lod_fresh = 0;
+    job_init(&step, step_particles, s);
+    job_init(&contacts, find_contacts, s);
+    job_init(&lod, prep_render, s);
+    job_init(&exporting, publish, s);
+
+    int with_contacts = s->params.contacts;
+    int with_lod = s->lod.density != NULL;
+    int with_export = s->exporter != NULL;
+    if (with_contacts) job_depends(&contacts, &step);
+    if (with_lod) job_depends(&lod, &step);
+    if (with_export) job_depends(&exporting, &step);
+
+    job_submit(&step, &done);
+    if (with_contacts) job_submit(&contacts, &done);
+    if (with_lod) job_submit(&lod, &done);
+    if (with_export) job_submit(&exporting, &done);
+    job_wait(&done);
+}
+
+static int command_hits(const struct Command *c, Vec2 p) {
+    return c->b <= 0.0f || vec2_len2(vec2_sub(p, c->p)) <= c->b * c->b;
+}
+
+struct CommandBatch {
+    const struct Command *cmds;
+    int count;
+};
+
+static int despawn_hit(const struct Particle *p, void *ctx) {
+    const struct CommandBatch *b = ctx;
+    for (int c = 0; c < b->count; c++)
+        if (b->cmds[c].kind == COMMAND_DESPAWN && command_hits(&b->cmds[c], p->position)) return 1;
+    return 0;
+}
+
+static int reserve_particles(struct ParticleSim *s, int n) {
+    if (n <= s->capacity) return 0;
+    int cap = s->capacity ? s->capacity * 2 : 64;
+    while (cap < n) cap *= 2;
+
+    struct Particle *particles = realloc(s->particles, (size_t)cap * sizeof(struct Particle));
+    if (!particles) return -1;
+    s->particles = particles;
+    Vec2 *forces = realloc(s->forces, (size_t)cap * sizeof(Vec2));
+    if (!forces) return -1;
+    s->forces = forces;
+    float *soa = realloc(s->soa, 4 * (size_t)cap * sizeof(float));
+    if (!soa) return -1;
+    s->soa = soa;
+
+    if (morton_reserve(&s->morton, cap)) return -1;
+    s->capacity = cap;
+    return 0;
+}
+
+// velocity changes first, then despawns, then spawns. the xpbd lattice
+// refers to particles by index, so that solver keeps its particle count
+// and refuses spawns and despawns, counted in ParticleStats.rejected
+static void apply_commands(void *ctx, const struct Command *cmds, int count) {
+    struct ParticleSim *s = ctx;
+    int n = s->params.num_particles;
+    int pushes = 0, despawns = 0, spawns = 0;
+    for (int c = 0; c < count; c++) {
+        pushes += cmds[c].kind == COMMAND_IMPULSE || cmds[c].kind == COMMAND_REPEL;
+        despawns += cmds[c].kind == COMMAND_DESPAWN;
+        spawns += cmds[c].kind == COMMAND_SPAWN;
+    }
+    int resize = s->params.solver != PARTICLE_SOLVER_XPBD;
+    if (!resize) s->rejected += despawns + spawns;
+
+    // one pass over the particles for the whole batch
+    if (pushes) {
+        for (int i = 0; i < n; i++) {
+            struct Particle *p = &s->particles[i];
+            for (int c = 0; c < count; c++) {
+                const struct Command *cmd = &cmds[c];
+                if (cmd->kind == COMMAND_IMPULSE && command_hits(cmd, p->position))
+                    p->linear_velocity = vec2_add(p->linear_velocity, cmd->v);
+                else if (cmd->kind == COMMAND_REPEL && command_hits(cmd, p->position))
+                    particle_repel(p, cmd->p, cmd->a);
+            }
         }
     }
 
-    for (int i = 0; i < NUM_PARTICLES; i++) {
-        struct Particle *p = &particles[i];
+    // compact in place so storage order (and morton locality) survives.
+    // stable ids stay with their particles, contacts of the removed ones
+    // end before spawns can reuse their ids
+    if (despawns && resize) {
+        struct CommandBatch batch = {cmds, count};
+        n = morton_remove(&s->morton, s->particles, n, despawn_hit, &batch);
+        if (s->params.contacts) contact_events_remove(&s->contacts, s->morton.index_of);
+    }
+
+    if (spawns && resize && reserve_particles(s, n + spawns)) s->rejected += spawns;
+    else if (spawns && resize) {
+        for (int c = 0; c < count; c++) {
+            const struct Command *cmd = &cmds[c];
+            if (cmd->kind != COMMAND_SPAWN) continue;
+            morton_append(&s->morton);
+            s->particles[n++] = (struct Particle){
+                .position = cmd->p,
+                .linear_velocity = cmd->v,
+                .mass = cmd->a > 0.0f ? cmd->a : 1.0f,
+                .color = BLACK,
+                .radius = cmd->b > 0.0f ? cmd->b : 2.0f
+            };
+        }
+    }
 
-        particle_attract(&particles[i], center, 10 * vec2_dist(particles[i].position, center));
-        particle_drag(&particles[i], 0.2f);
-        particle_update(p, dt);
-        //particle_draw_arrow(p, vec2_len(p->linear_velocity));
-        //particle_wrap_screen(p, config);
+    if (n != s->params.num_particles) {
+        s->params.num_particles = n;
+        s->lod_fresh = 0;
+        neighbor_invalidate(&s->neighbors);
     }
 }
 
-static void render(void) {
-    for (int i = 0; i<NUM_PARTICLES; i++) {
-        particle_render(&particles[i]);
+static void render_world(const struct StaticWorld *w) {
+    for (int i = 0; i < w->num_shapes; i++) {
+        const struct StaticShape *sh = &w->shapes[i];
+        if (sh->kind == STATIC_LINE) {
+            DrawLineV((Vector2){sh->corners[0].x, sh->corners[0].y},
+                      (Vector2){sh->corners[1].x, sh->corners[1].y}, DARKGRAY);
+            continue;
+        }
+        for (int e = 0; e < 4; e++) {
+            Vec2 a = sh->corners[e], b = sh->corners[(e + 1) % 4];
+            DrawLineV((Vector2){a.x, a.y}, (Vector2){b.x, b.y}, DARKGRAY);
+        }
+    }
+}
+
+// gpu side of the render lod, only runs with a window open
+static void render_density(struct ParticleSim *s) {
+    if (!s->density.id) {
+        Image img = GenImageColor(s->lod.grid_w, s->lod.grid_h, BLANK);
+        s->density = LoadTextureFromImage(img);
+        UnloadImage(img);
+    }
+    UpdateTexture(s->density, s->lod.pixels);
+    DrawTextureEx(s->density, (Vector2){0, 0}, 0.0f, (float)s->lod.texel, WHITE);
+}
+
+static void render(void *ctx) {
+    struct ParticleSim *s = ctx;
+    const int n = s->params.num_particles;
+    if (s->world) render_world(s->world);
+
+    if (!s->lod.density && render_lod_init(&s->lod, s->config->width, s->config->height, 1)) {
+        for (int i = 0; i < n; i++) particle_render(&s->particles[i]);
+        return;
     }
+    // physics preps it once the lod exists, this covers the first frame
+    // and frames after spawns or despawns
+    if (!s->lod_fresh) prep_render(s);
+    if (!s->lod_fresh) return;
+
+    if (s->lod.splatted) render_density(s);
+    for (int i = 0; i < s->lod.num_circles; i++)
+        particle_render(&s->particles[s->lod.circles[i]]);
+}
+
+static void destroy(void *ctx) {
+    struct ParticleSim *s = ctx;
+    if (!s) return;
+    free(s->particles);
+    free(s->forces);
+    free(s->soa);
+    xpbd_free(&s->xpbd);
+    morton_free(&s->morton);
+    pm_free(&s->pm);
+    neighbor_free(&s->neighbors);
+    render_lod_free(&s->lod);
+    contact_events_free(&s->contacts);
+    blockstep_free(&s->block);
+    // the texture went with the gl context if the window is already closed
+    if (s->density.id && IsWindowReady()) UnloadTexture(s->density);
+    free(s);
+}
+
+Simulation particle_sim_with(const struct ParticleParams *params, uint64_t seed) {
+    struct ParticleSim *s = calloc(1, sizeof(struct ParticleSim));
+    if (s) {
+        s->params = *params;
+        rng_seed(&s->rng, seed, 0);
+    }
+    return (Simulation){s, init, physics, render, destroy, apply_commands, NULL};
+}
+
+void particle_sim_set_world(Simulation *sim, const struct StaticWorld *world) {
+    struct ParticleSim *s = sim->ctx;
+    s->world = world;
+}
+
+void particle_sim_set_exporter(Simulation *sim, struct Exporter *ex) {
+    struct ParticleSim *s = sim->ctx;
+    s->exporter = ex;
+}
+
+Simulation particle_sim_scene(const struct Scene *scene, const struct ParticleParams *params, uint64_t seed) {
+    Simulation sim = particle_sim_with(params, seed);
+    if (sim.ctx) ((struct ParticleSim *)sim.ctx)->scene = scene;
+    return sim;
+}
+
+Simulation particle_sim(uint64_t seed) {
+    struct ParticleParams params = particle_params_default();
+    return particle_sim_with(&params, seed);
+}
+
+struct ParticleStats particle_sim_stats(const Simulation *sim) {
+    const struct ParticleSim *s = sim->ctx;
+    const int n = s->params.num_particles;
+    struct ParticleStats st = {0};
+    st.rejected = s->rejected;
+    if (n <= 0 || !s->particles) return st;
+
+    Vec2 sum = vec2(0, 0);
+    for (int i = 0; i < n; i++) {
+        const struct Particle *p = &s->particles[i];
+        st.kinetic_energy += 0.5f * p->mass * vec2_len2(p->linear_velocity);
+        sum = vec2_add(sum, p->position);
+    }
+    st.centroid = vec2_scale(sum, 1.0f / n);
+
+    float r2 = 0.0f;
+    for (int i = 0; i < n; i++)
+        r2 += vec2_len2(vec2_sub(s->particles[i].position, st.centroid));
+    st.spread = sqrtf(r2 / n);
+    st.force_evals = s->force_evals;
+    return st;
+}
+
+const struct Particle *particle_sim_particles(const Simulation *sim, int *n) {
+    const struct ParticleSim *s = sim->ctx;
+    *n = s->particles ? s->params.num_particles : 0;
+    return s->particles;
+}
+
+const struct ContactEvents *particle_sim_contacts(const Simulation *sim) {
+    const struct ParticleSim *s = sim->ctx;
+    return s->params.contacts ? &s->contacts : NULL;
 }
 
-Simulation particle_sim(void) {
-    return (Simulation){init, physics, render};
+int particle_sim_index_of(const Simulation *sim, uint32_t id) {
+    const struct ParticleSim *s = sim->ctx;
+    if (id >= (uint32_t)s->morton.capacity) return -1;
+    return s->morton.index_of[id];
 }
@@ -1,5 +1,84 @@
 #pragma once
 
+#include <stdint.h>
 #include "sim.h"
+#include "engine/vec2.h"
 
-Simulation particle_sim(void);
+enum ParticleSolver {
+    PARTICLE_SOLVER_FORCES, // explicit pair springs
+    PARTICLE_SOLVER_XPBD,   // lattice + contact + boundary constraints
+    PARTICLE_SOLVER_PM,     // particle-mesh gravity instead of pair springs
+};
+
+// tunables for one particle sim instance
+struct ParticleParams {
+    int num_particles;
+    float G;               // pair spring strength, gravity constant for pm
+    float target_dist;     // pair rest distance
+    float interact_radius; // pairs further apart than this are skipped
+    float random_offset;   // max spawn jitter around the grid
+    float drag;            // linear drag coefficient
+    float center_pull;     // constant pull toward the screen center
+    int solver;            // enum ParticleSolver
+    int solver_iterations; // xpbd only
+    float compliance;      // xpbd lattice compliance, 0 is rigid
+    int pm_grid;           // pm nodes per side, power of two
+    int contacts;          // record contact events, see particle_sim_contacts
+    int periodic;          // screen wraps around (torus), not for xpbd.
+                           // interact_radius is capped at half the screen
+    int block_levels;      // forces solver only: particles step at down to
+                           // 1 / 2^block_levels of dt as they need, 0 is off
+    float block_accuracy;  // px a particle may move or bend per own step
+    int simd;              // 0 keeps the pair kernels scalar, even with avx2
+};
+
+// what the interactive build uses
+struct ParticleParams particle_params_default(void);
+
+// new particle sim instance, free with sim.destroy(sim.ctx).
+// ctx is NULL if allocation failed
+Simulation particle_sim(uint64_t seed);
+Simulation particle_sim_with(const struct ParticleParams *params, uint64_t seed);
+
+// start from a loaded scene instead of the procedural grid. num_particles
+// comes from the scene, init copies the particles out of it, so the scene
+// only has to outlive init
+struct Scene;
+Simulation particle_sim_scene(const struct Scene *scene, const struct ParticleParams *params, uint64_t seed);
+
+// collide particles against baked static walls every step. the world is
+// only read, it must outlive the sim. NULL turns it off
+struct StaticWorld;
+void particle_sim_set_world(Simulation *sim, const struct StaticWorld *world);
+
+// publish the particles to ex at the end of every physics step. ex is not
+// owned and must outlive the sim. NULL turns it off
+struct Exporter;
+void particle_sim_set_exporter(Simulation *sim, struct Exporter *ex);
+
+// whole-swarm summary, for headless runs
+struct ParticleStats {
+    float kinetic_energy; // sum of 0.5 m v^2
+    float spread;         // rms distance from the centroid
+    Vec2 centroid;
+    long force_evals;     // particle forces evaluated in the last step,
+                          // n unless block steps skipped some
+    long rejected;        // commands refused so far: spawns and despawns
+                          // under xpbd, spawns that found no memory
+};
+
+struct ParticleStats particle_sim_stats(const Simulation *sim);
+
+// the live particles in storage order, read them between steps.
+// *n gets the count
+struct Particle;
+const struct Particle *particle_sim_particles(const Simulation *sim, int *n);
+
+// contact events of the last steps, read them between steps with
+// contact_events_read. NULL unless params.contacts was set
+struct ContactEvents;
+const struct ContactEvents *particle_sim_contacts(const Simulation *sim);
+
+// events name particles by stable id, this is where one is stored now.
+// -1 if it was despawned
+int particle_sim_index_of(const Simulation *sim, uint32_t id);
@@ -1,9 +1,17 @@
 #pragma once
 
 #include "engine/app.h"
+#include "engine/command.h"
 
+// every callback gets the sim's own ctx, so any number of sims can live
+// in one process (one per thread etc)
 typedef struct Simulation {
-    void (*init)(const AppConfig *config);
-    void (*physics)(float dt);
-    void (*render)(void);
+    void *ctx;
+    void (*init)(void *ctx, const AppConfig *config);
+    void (*physics)(void *ctx, float dt);
+    void (*render)(void *ctx);
+    void (*destroy)(void *ctx);
+    // a batch of queued commands, in push order. may be NULL
+    void (*apply)(void *ctx, const struct Command *cmds, int count);
+    struct CommandQueue *commands; // not owned, may be NULL
 } Simulation;
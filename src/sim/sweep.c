@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "sweep.h"
+#include "engine/app.h"
+#include "engine/parallel.h"
+
+struct Batch {
+    struct SweepRun *runs;
+    int steps;
+    float dt;
+    struct Exporter *exporter; // run 0 only, may be NULL
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+void sweep_params_init(struct SweepParam params[SWEEP_NUM_PARAMS]) {
+    const struct SweepParam all[SWEEP_NUM_PARAMS] = {
+        {"--n",      offsetof(struct ParticleParams, num_particles),   1, {{0}, 0}},
+        {"--G",      offsetof(struct ParticleParams, G),               0, {{0}, 0}},
+        {"--target", offsetof(struct ParticleParams, target_dist),     0, {{0}, 0}},
+        {"--radius", offsetof(struct ParticleParams, interact_radius), 0, {{0}, 0}},
+        {"--offset", offsetof(struct ParticleParams, random_offset),   0, {{0}, 0}},
+        {"--drag",   offsetof(struct ParticleParams, drag),            0, {{0}, 0}},
+        {"--pull",   offsetof(struct ParticleParams, center_pull),     0, {{0}, 0}},
+        {"--solver", offsetof(struct ParticleParams, solver),            1, {{0}, 0}},
+        {"--iters",  offsetof(struct ParticleParams, solver_iterations), 1, {{0}, 0}},
+        {"--compliance", offsetof(struct ParticleParams, compliance),    0, {{0}, 0}},
+        {"--pm-grid", offsetof(struct ParticleParams, pm_grid),          1, {{0}, 0}},
+        {"--levels", offsetof(struct ParticleParams, block_levels),      1, {{0}, 0}},
+        {"--accuracy", offsetof(struct ParticleParams, block_accuracy),  0, {{0}, 0}},
+    };
+    for (int i = 0; i < SWEEP_NUM_PARAMS; i++)
+        params[i] = all[i];
+}
+
+int sweep_parse_list(const char *arg, struct SweepValues *out) {
+    out->count = 0;
+    float lo, hi;
+    int count;
+    if (sscanf(arg, "%f:%f:%d", &lo, &hi, &count) == 3) {
+        if (count < 1 || count > SWEEP_MAX_VALUES) return -1;
+        for (int i = 0; i < count; i++)
+            out->v[out->count++] = count == 1 ? lo : lo + (hi - lo) * i / (count - 1);
+        return 0;
+    }
+
+    const char *p = arg;
+    while (*p) {
+        char *end;
+        float v = strtof(p, &end);
+        if (end == p || out->count >= SWEEP_MAX_VALUES) return -1;
+        out->v[out->count++] = v;
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return -1;
+    }
+    return out->count > 0 ? 0 : -1;
+}
+
+static void set_param(struct ParticleParams *p, const struct SweepParam *s, float v) {
+    char *field = (char *)p + s->offset;
+    if (s->is_int) *(int *)field = (int)v;
+    else *(float *)field = v;
+}
+
+long sweep_size(struct SweepParam *params, int num, const struct ParticleParams *base, int seeds) {
+    long total = seeds;
+    for (int s = 0; s < num; s++) {
+        if (params[s].values.count == 0) {
+            const char *field = (const char *)base + params[s].offset;
+            params[s].values.v[0] = params[s].is_int ? (float)*(const int *)field : *(const float *)field;
+            params[s].values.count = 1;
+        }
+        total *= params[s].values.count;
+    }
+    return total;
+}
+
+void sweep_expand(struct SweepRun *runs, long total, const struct SweepParam *params, int num,
+                  const struct ParticleParams *base, int seeds, uint64_t first_seed) {
+    for (long r = 0; r < total; r++) {
+        long rest = r / seeds;
+        runs[r] = (struct SweepRun){.params = *base, .seed = first_seed + (uint64_t)(r % seeds)};
+        for (int s = num - 1; s >= 0; s--) {
+            int c = params[s].values.count;
+            set_param(&runs[r].params, &params[s], params[s].values.v[rest % c]);
+            rest /= c;
+        }
+    }
+}
+
+float sweep_settle_time(const float *ke, int steps, float dt) {
+    float peak = 0.0f;
+    for (int i = 0; i < steps; i++)
+        if (ke[i] > peak) peak = ke[i];
+    int last_hot = steps - 1;
+    while (last_hot >= 0 && ke[last_hot] <= peak * SWEEP_SETTLE_FRACTION)
+        last_hot--;
+    return last_hot < steps - 1 ? (last_hot + 1) * dt : -1.0f;
+}
+
+static void run_one(struct SweepRun *run, int steps, float dt, struct Exporter *ex) {
+    AppConfig config = {800, 600, "batch"};
+    Simulation sim = particle_sim_with(&run->params, run->seed);
+    if (!sim.ctx) {
+        run->settle_time = -1.0f;
+        return;
+    }
+
+    float *ke = malloc((size_t)steps * sizeof(float));
+    double start = now_ms();
+
+    if (ex) particle_sim_set_exporter(&sim, ex);
+    sim.init(sim.ctx, &config);
+    float sum = 0.0f;
+    double evals = 0.0;
+    struct ParticleStats st = {0};
+    for (int i = 0; i < steps; i++) {
+        sim.physics(sim.ctx, dt);
+        st = particle_sim_stats(&sim);
+        if (ke) ke[i] = st.kinetic_energy;
+        sum += st.kinetic_energy;
+        evals += st.force_evals;
+    }
+
+    run->wall_ms = now_ms() - start;
+    run->settle_time = ke ? sweep_settle_time(ke, steps, dt) : -1.0f;
+    run->final_ke = st.kinetic_energy;
+    run->mean_ke = steps > 0 ? sum / steps : 0.0f;
+    run->final_spread = st.spread;
+    run->mean_evals = steps > 0 ? (float)(evals / steps) : 0.0f;
+
+    free(ke);
+    sim.destroy(sim.ctx);
+}
+
+static void run_range(void *ctx, int begin, int end) {
+    struct Batch *b = ctx;
+    for (int i = begin; i < end; i++)
+        run_one(&b->runs[i], b->steps, b->dt, i == 0 ? b->exporter : NULL);
+}
+
+void sweep_run(struct SweepRun *runs, long total, int steps, float dt, struct Exporter *ex) {
+    struct Batch batch = {runs, steps, dt, ex};
+    parallel_for((int)total, 1, run_range, &batch);
+}
+
+void sweep_write_csv(FILE *out, const struct SweepRun *runs, long total) {
+    fprintf(out, "run,seed,n,G,target_dist,interact_radius,random_offset,drag,center_pull,"
+                 "solver,iters,compliance,pm_grid,levels,accuracy,final_ke,mean_ke,final_spread,settle_time,"
+                 "mean_evals,wall_ms\n");
+    for (long r = 0; r < total; r++) {
+        const struct SweepRun *run = &runs[r];
+        const struct ParticleParams *p = &run->params;
+        fprintf(out, "%ld,%llu,%d,%g,%g,%g,%g,%g,%g,%d,%d,%g,%d,%d,%g,%g,%g,%g,%g,%g,%.3f\n",
+                r, (unsigned long long)run->seed, p->num_particles, p->G, p->target_dist,
+                p->interact_radius, p->random_offset, p->drag, p->center_pull,
+                p->solver, p->solver_iterations, p->compliance, p->pm_grid,
+                p->block_levels, p->block_accuracy,
+                run->final_ke, run->mean_ke, run->final_spread, run->settle_time,
+                run->mean_evals, run->wall_ms);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "particle.h"
+
+// headless parameter sweeps over the particle sim, the engine of
+// tools/batch. every combination of the swept values is run once per seed,
+// seed varying fastest, and each run is reduced to a few metrics.
+//
+//   struct SweepParam params[SWEEP_NUM_PARAMS];
+//   sweep_params_init(params);
+//   sweep_parse_list("0.05,0.1", &params[1].values);  // --G
+//   long total = sweep_size(params, SWEEP_NUM_PARAMS, &base, seeds);
+//   sweep_expand(runs, total, params, SWEEP_NUM_PARAMS, &base, seeds, 1);
+//   sweep_run(runs, total, steps, dt, NULL);
+//   sweep_write_csv(stdout, runs, total);
+
+#define SWEEP_MAX_VALUES 256
+#define SWEEP_NUM_PARAMS 13
+#define SWEEP_SETTLE_FRACTION 0.01f // settled once ke stays under 1% of its peak
+
+struct SweepValues {
+    float v[SWEEP_MAX_VALUES];
+    int count;
+};
+
+// one sweepable parameter, offset points into ParticleParams
+struct SweepParam {
+    const char *flag;
+    size_t offset;
+    int is_int;
+    struct SweepValues values; // empty means the base value
+};
+
+struct SweepRun {
+    struct ParticleParams params;
+    uint64_t seed;
+    // results
+    float final_ke, mean_ke, final_spread, settle_time, mean_evals;
+    double wall_ms;
+};
+
+// every sweepable param with its batch flag, no values yet
+void sweep_params_init(struct SweepParam params[SWEEP_NUM_PARAMS]);
+
+// "a,b,c" or "lo:hi:count" (inclusive). returns -1 on a malformed list
+int sweep_parse_list(const char *arg, struct SweepValues *out);
+
+// gives every unswept param its base value and returns the number of runs
+long sweep_size(struct SweepParam *params, int num, const struct ParticleParams *base, int seeds);
+
+// fills runs[0, total) with the grid, seeds first_seed, first_seed + 1, ...
+void sweep_expand(struct SweepRun *runs, long total, const struct SweepParam *params, int num,
+                  const struct ParticleParams *base, int seeds, uint64_t first_seed);
+
+// runs everything on the job system. ex (may be NULL) gets run 0 only
+struct Exporter;
+void sweep_run(struct SweepRun *runs, long total, int steps, float dt, struct Exporter *ex);
+
+// end of the last step whose ke was above SWEEP_SETTLE_FRACTION of the peak,
+// -1 if the run never settled
+float sweep_settle_time(const float *ke, int steps, float dt);
+
+// header plus one row per run
+void sweep_write_csv(FILE *out, const struct SweepRun *runs, long total);
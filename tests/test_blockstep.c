@@ -0,0 +1,202 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+
+#include "engine/blockstep.h"
+
+#define DT (1.0f / 60.0f)
+
+// ─── choose ──────────────────────────────────────────────────────
+
+// the finest level the accuracy criterion asks for, straight from the doc:
+// largest dt / 2^level with 0.5 * accel * step^2 <= accuracy
+static int expected_level(float accel, float speed, float accuracy, int max_level) {
+    for (int level = 0; level < max_level; level++) {
+        float step = DT / (float)(1 << level);
+        if (speed * step <= accuracy && 0.5f * accel * step * step <= accuracy) return level;
+    }
+    return max_level;
+}
+
+static void test_level_follows_acceleration(void) {
+    struct BlockStep b;
+    blockstep_init(&b, 6, 0.5f);
+    CU_ASSERT_EQUAL_FATAL(blockstep_reserve(&b, 1), 0);
+
+    // a doubling of acceleration is half a level of step, so sweep finely
+    int ok = 1, levels_seen = 0, last = -1;
+    for (float a = 1.0f; a < 1e7f; a *= 1.1f) {
+        int level = blockstep_choose(&b, 0, 0, a, 0.0f, DT);
+        if (level != expected_level(a, 0.0f, 0.5f, 6)) ok = 0;
+        if (level < last) ok = 0; // more acceleration never coarsens
+        if (level != last) levels_seen++;
+        last = level;
+        if (b.level[0] != level) ok = 0;
+    }
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_EQUAL(levels_seen, 7); // 0 through 6
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 0, 0.0f, 0.0f, DT), 0);
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 0, 1e12f, 0.0f, DT), 6); // capped
+    blockstep_free(&b);
+}
+
+static void test_level_follows_speed(void) {
+    struct BlockStep b;
+    blockstep_init(&b, 4, 1.0f);
+    CU_ASSERT_EQUAL_FATAL(blockstep_reserve(&b, 1), 0);
+    int ok = 1;
+    for (float v = 1.0f; v < 1e5f; v *= 1.3f)
+        if (blockstep_choose(&b, 0, 0, 0.0f, v, DT) != expected_level(0.0f, v, 1.0f, 4)) ok = 0;
+    CU_ASSERT_TRUE(ok);
+    blockstep_free(&b);
+}
+
+// a particle can only go coarse on a substep that starts the coarser step
+static void test_coarsening_waits_for_alignment(void) {
+    struct BlockStep b;
+    blockstep_init(&b, 3, 1.0f);
+    CU_ASSERT_EQUAL_FATAL(blockstep_reserve(&b, 1), 0);
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 1, 0.0f, 0.0f, DT), 3);
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 2, 0.0f, 0.0f, DT), 2);
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 4, 0.0f, 0.0f, DT), 1);
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 6, 0.0f, 0.0f, DT), 2);
+    CU_ASSERT_EQUAL(blockstep_choose(&b, 0, 0, 0.0f, 0.0f, DT), 0);
+    blockstep_free(&b);
+}
+
+// ─── gather ──────────────────────────────────────────────────────
+
+static void test_gather_by_level(void) {
+    struct BlockStep b;
+    blockstep_init(&b, 2, 1.0f);
+    CU_ASSERT_EQUAL_FATAL(blockstep_reserve(&b, 3), 0);
+    b.level[0] = 0;
+    b.level[1] = 1;
+    b.level[2] = 2;
+
+    int counts[4];
+    for (int s = 0; s < blockstep_substeps(&b); s++)
+        counts[s] = blockstep_gather(&b, s, 3);
+    CU_ASSERT_EQUAL(counts[0], 3); // everyone
+    CU_ASSERT_EQUAL(counts[1], 1); // level 2
+    CU_ASSERT_EQUAL(counts[2], 2); // levels 1 and 2
+    CU_ASSERT_EQUAL(counts[3], 1);
+    CU_ASSERT_EQUAL(b.active[0], 2);
+    CU_ASSERT_EQUAL(b.evaluations, 7);
+    blockstep_free(&b);
+}
+
+// ─── integration ─────────────────────────────────────────────────
+
+// a clustered scene in 1d: mostly slow particles in a weak well plus a few
+// pairs tied by a stiff spring, stepped the way physics_block does it.
+// kick the active ones over their own step, drift everyone over the substep
+#define SLOW 60
+#define PAIRS 2
+#define NUM (SLOW + 2 * PAIRS)
+#define AMPLITUDE 20.0f
+#define SPRING 10000.0f // pair w = sqrt(2 * SPRING), about 140 rad/s
+#define REST 10.0f
+#define MAX_LEVEL 5
+#define STEPS 120
+
+static float well(int i) {
+    return i < SLOW ? 0.3f + 0.7f * (float)i / (SLOW - 1) : 0.5f;
+}
+
+static float accel(const float *x, int i) {
+    float a = -well(i) * well(i) * x[i];
+    if (i >= SLOW) {
+        int partner = SLOW + ((i - SLOW) ^ 1);
+        float side = (i - SLOW) & 1 ? 1.0f : -1.0f; // odd one sits on the right
+        a -= SPRING * (x[i] - x[partner] - side * REST);
+    }
+    return a;
+}
+
+// trail[step * NUM + i] is particle i after each base step
+static long run(float accuracy, float *trail) {
+    struct BlockStep b;
+    blockstep_init(&b, MAX_LEVEL, accuracy);
+    blockstep_reserve(&b, NUM);
+    float x[NUM], v[NUM];
+    for (int i = 0; i < SLOW; i++) {
+        x[i] = AMPLITUDE * (i % 2 ? 1.0f : -1.0f);
+        v[i] = 0.0f;
+    }
+    for (int p = 0; p < PAIRS; p++) {
+        float center = -AMPLITUDE + 2.0f * AMPLITUDE * p;
+        x[SLOW + 2 * p] = center - 0.5f * REST - 1.0f; // stretched by 2
+        x[SLOW + 2 * p + 1] = center + 0.5f * REST + 1.0f;
+        v[SLOW + 2 * p] = v[SLOW + 2 * p + 1] = 0.0f;
+    }
+
+    long evals = 0;
+    const int substeps = blockstep_substeps(&b);
+    const float h = DT / substeps;
+    for (int step = 0; step < STEPS; step++) {
+        b.evaluations = 0;
+        for (int sub = 0; sub < substeps; sub++) {
+            int count = blockstep_gather(&b, sub, NUM);
+            for (int k = 0; k < count; k++) {
+                int i = b.active[k];
+                float a = accel(x, i);
+                int level = blockstep_choose(&b, i, sub, fabsf(a), fabsf(v[i]), DT);
+                v[i] += a * DT * blockstep_fraction(level);
+            }
+            for (int i = 0; i < NUM; i++) x[i] += v[i] * h;
+        }
+        evals += b.evaluations;
+        for (int i = 0; i < NUM; i++) trail[step * NUM + i] = x[i];
+    }
+    blockstep_free(&b);
+    return evals;
+}
+
+// accuracy 0 puts everyone on the finest level every substep, which is a
+// plain single-level run at dt / 2^MAX_LEVEL. the slow majority stays on
+// coarse levels, so block steps cut the evaluations by a large factor, and
+// the slow trajectories must follow the single-level ones all along
+static void test_matches_single_level(void) {
+    static float block[STEPS * NUM], fine[STEPS * NUM];
+    long block_evals = run(0.5f, block);
+    long fine_evals = run(0.0f, fine);
+    CU_ASSERT_EQUAL(fine_evals, (long)STEPS * NUM * (1 << MAX_LEVEL));
+    CU_ASSERT_TRUE(block_evals * 4 < fine_evals);
+
+    float slow = 0.0f, stretch = 0.0f;
+    for (int step = 0; step < STEPS; step++) {
+        for (int i = 0; i < SLOW; i++)
+            slow = fmaxf(slow, fabsf(block[step * NUM + i] - fine[step * NUM + i]));
+        // the fast pairs only have to stay bound, they started stretched by 2
+        for (int p = 0; p < PAIRS; p++) {
+            int a = step * NUM + SLOW + 2 * p;
+            stretch = fmaxf(stretch, fabsf(block[a + 1] - block[a] - REST));
+        }
+    }
+    CU_ASSERT_TRUE(slow < 0.01f * AMPLITUDE);
+    CU_ASSERT_TRUE(stretch < 4.0f);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("blockstep_levels", NULL, NULL);
+    CU_add_test(s1, "acceleration", test_level_follows_acceleration);
+    CU_add_test(s1, "speed",        test_level_follows_speed);
+    CU_add_test(s1, "alignment",    test_coarsening_waits_for_alignment);
+    CU_add_test(s1, "gather",       test_gather_by_level);
+
+    CU_pSuite s2 = CU_add_suite("blockstep_integration", NULL, NULL);
+    CU_add_test(s2, "single_level", test_matches_single_level);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
@@ -412,6 +412,46 @@ static void test_line_vs_square_rotated_miss(void) {
     CU_ASSERT_FALSE(line_vs_square(l, s));
 }
 
+// ─── periodic ────────────────────────────────────────────────────
+
+static void test_periodic_sub_wraps(void) {
+    Vec2 d = vec2_sub_periodic(vec2(1, 50), vec2(99, 50), vec2(100, 100));
+    CU_ASSERT_DOUBLE_EQUAL(d.x, 2.0f, 1e-4);
+    CU_ASSERT_DOUBLE_EQUAL(d.y, 0.0f, 1e-4);
+}
+
+static void test_periodic_sub_open_axis(void) {
+    // period 0 on x leaves it alone
+    Vec2 d = vec2_sub_periodic(vec2(1, 1), vec2(99, 99), vec2(0, 100));
+    CU_ASSERT_DOUBLE_EQUAL(d.x, -98.0f, 1e-4);
+    CU_ASSERT_DOUBLE_EQUAL(d.y, 2.0f, 1e-4);
+}
+
+static void test_periodic_wrap(void) {
+    Vec2 p = vec2_wrap(vec2(-5, 230), vec2(0, 0), vec2(100, 100));
+    CU_ASSERT_DOUBLE_EQUAL(p.x, 95.0f, 1e-4);
+    CU_ASSERT_DOUBLE_EQUAL(p.y, 30.0f, 1e-4);
+}
+
+static void test_circle_vs_circle_periodic_across_edge(void) {
+    struct Circle a = { vec2(1, 50), 2.0f };
+    struct Circle b = { vec2(98, 50), 2.0f };
+    CU_ASSERT_FALSE(circle_vs_circle(a, b));
+    CU_ASSERT_TRUE(circle_vs_circle_periodic(a, b, vec2(100, 100)));
+}
+
+static void test_circle_vs_circle_periodic_corner(void) {
+    struct Circle a = { vec2(1, 1), 2.0f };
+    struct Circle b = { vec2(99, 99), 2.0f };
+    CU_ASSERT_TRUE(circle_vs_circle_periodic(a, b, vec2(100, 100)));
+}
+
+static void test_circle_vs_circle_periodic_apart(void) {
+    struct Circle a = { vec2(10, 50), 2.0f };
+    struct Circle b = { vec2(60, 50), 2.0f };
+    CU_ASSERT_FALSE(circle_vs_circle_periodic(a, b, vec2(100, 100)));
+}
+
 // ─── main ────────────────────────────────────────────────────────
 
 int main(void) {
@@ -509,6 +549,15 @@ int main(void) {
     CU_add_test(s11, "rotated",              test_line_vs_square_rotated);
     CU_add_test(s11, "rotated_miss",         test_line_vs_square_rotated_miss);
 
+    // periodic
+    CU_pSuite s12 = CU_add_suite("periodic", NULL, NULL);
+    CU_add_test(s12, "sub_wraps",          test_periodic_sub_wraps);
+    CU_add_test(s12, "sub_open_axis",      test_periodic_sub_open_axis);
+    CU_add_test(s12, "wrap",               test_periodic_wrap);
+    CU_add_test(s12, "circle_across_edge", test_circle_vs_circle_periodic_across_edge);
+    CU_add_test(s12, "circle_corner",      test_circle_vs_circle_periodic_corner);
+    CU_add_test(s12, "circle_apart",       test_circle_vs_circle_periodic_apart);
+
     CU_basic_set_mode(CU_BRM_VERBOSE);
     CU_basic_run_tests();
     unsigned int failures = CU_get_number_of_failures();
@@ -0,0 +1,157 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+#include "engine/vec2.h"
+#include "engine/command.h"
+
+#define PRODUCERS 4
+#define PER_PRODUCER 200000
+
+// producer and sequence number ride in the impulse, exact as floats
+static struct Command tagged(int producer, int seq) {
+    return command_impulse(vec2(0, 0), 1.0f, vec2((float)producer, (float)seq));
+}
+
+// ─── single thread ───────────────────────────────────────────────
+
+static void test_capacity_rounds_up(void) {
+    struct CommandQueue q;
+    CU_ASSERT_EQUAL_FATAL(command_queue_init(&q, 5), 0);
+    CU_ASSERT_EQUAL(q.mask + 1, 8);
+    command_queue_free(&q);
+}
+
+// a full queue refuses pushes and counts them, and frees up as it drains
+static void test_full_queue(void) {
+    struct CommandQueue q;
+    CU_ASSERT_EQUAL_FATAL(command_queue_init(&q, 8), 0);
+    for (int i = 0; i < 8; i++)
+        CU_ASSERT_EQUAL(command_queue_push(&q, tagged(0, i)), 0);
+    CU_ASSERT_EQUAL(command_queue_push(&q, tagged(0, 8)), -1);
+    CU_ASSERT_EQUAL(command_queue_push(&q, tagged(0, 8)), -1);
+    CU_ASSERT_EQUAL(q.dropped, 2);
+
+    struct Command out[8];
+    CU_ASSERT_EQUAL(command_queue_pop(&q, out, 3), 3);
+    CU_ASSERT_DOUBLE_EQUAL(out[2].v.y, 2, 0);
+    for (int i = 8; i < 11; i++)
+        CU_ASSERT_EQUAL(command_queue_push(&q, tagged(0, i)), 0);
+    CU_ASSERT_EQUAL(command_queue_push(&q, tagged(0, 11)), -1);
+    CU_ASSERT_EQUAL(q.dropped, 3);
+
+    // everything accepted comes out once, in order, across the wrap
+    CU_ASSERT_EQUAL(command_queue_pop(&q, out, 8), 8);
+    int ok = 1;
+    for (int i = 0; i < 8; i++)
+        if (out[i].kind != COMMAND_IMPULSE || (int)out[i].v.y != 3 + i) ok = 0;
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_EQUAL(command_queue_pop(&q, out, 8), 0);
+    command_queue_free(&q);
+}
+
+static void test_commands_round_trip(void) {
+    struct CommandQueue q;
+    CU_ASSERT_EQUAL_FATAL(command_queue_init(&q, 4), 0);
+    command_queue_push(&q, command_spawn(vec2(1, 2), vec2(3, 4), 5, 6));
+    command_queue_push(&q, command_despawn(vec2(7, 8), 9));
+    command_queue_push(&q, command_repel(vec2(1, 1), 20, 300));
+
+    struct Command out[4];
+    CU_ASSERT_EQUAL_FATAL(command_queue_pop(&q, out, 4), 3);
+    CU_ASSERT_EQUAL(out[0].kind, COMMAND_SPAWN);
+    CU_ASSERT_DOUBLE_EQUAL(out[0].a, 5, 0);
+    CU_ASSERT_DOUBLE_EQUAL(out[0].b, 6, 0);
+    CU_ASSERT_EQUAL(out[1].kind, COMMAND_DESPAWN);
+    CU_ASSERT_DOUBLE_EQUAL(out[1].b, 9, 0);
+    CU_ASSERT_EQUAL(out[2].kind, COMMAND_REPEL);
+    CU_ASSERT_DOUBLE_EQUAL(out[2].a, 300, 0); // strength
+    CU_ASSERT_DOUBLE_EQUAL(out[2].b, 20, 0);  // radius
+    command_queue_free(&q);
+}
+
+// ─── many producers ──────────────────────────────────────────────
+
+struct Producer {
+    struct CommandQueue *q;
+    int id;
+    long retries;
+};
+
+// a full queue drops, so retry until the consumer makes room
+static void *produce(void *arg) {
+    struct Producer *p = arg;
+    for (int seq = 0; seq < PER_PRODUCER; seq++) {
+        while (command_queue_push(p->q, tagged(p->id, seq))) {
+            p->retries++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// a small queue so producers keep lapping the consumer and hitting full.
+// every command shows up exactly once and each producer's in push order
+static void test_many_producers(void) {
+    struct CommandQueue q;
+    CU_ASSERT_EQUAL_FATAL(command_queue_init(&q, 64), 0);
+
+    pthread_t threads[PRODUCERS];
+    struct Producer producers[PRODUCERS];
+    for (int i = 0; i < PRODUCERS; i++) {
+        producers[i] = (struct Producer){&q, i, 0};
+        pthread_create(&threads[i], NULL, produce, &producers[i]);
+    }
+
+    int next[PRODUCERS] = {0};
+    long total = 0, bad = 0;
+    struct Command batch[32];
+    while (total < (long)PRODUCERS * PER_PRODUCER) {
+        int got = command_queue_pop(&q, batch, 32);
+        if (!got) sched_yield();
+        for (int k = 0; k < got; k++) {
+            int p = (int)batch[k].v.x, seq = (int)batch[k].v.y;
+            if (p < 0 || p >= PRODUCERS || seq != next[p]) bad++;
+            else next[p]++;
+        }
+        total += got;
+    }
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_join(threads[i], NULL);
+
+    CU_ASSERT_EQUAL(bad, 0);
+    for (int i = 0; i < PRODUCERS; i++)
+        CU_ASSERT_EQUAL(next[i], PER_PRODUCER);
+    CU_ASSERT_EQUAL(command_queue_pop(&q, batch, 32), 0);
+
+    long retries = 0;
+    for (int i = 0; i < PRODUCERS; i++) retries += producers[i].retries;
+    CU_ASSERT_EQUAL(q.dropped, (size_t)retries);
+    command_queue_free(&q);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("command_queue", NULL, NULL);
+    CU_add_test(s1, "capacity",   test_capacity_rounds_up);
+    CU_add_test(s1, "full",       test_full_queue);
+    CU_add_test(s1, "round_trip", test_commands_round_trip);
+
+    CU_pSuite s2 = CU_add_suite("command_queue_mpsc", NULL, NULL);
+    CU_add_test(s2, "many_producers", test_many_producers);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <stdlib.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/contact.h"
+
+static struct Particle at(float x, float y) {
+    return (struct Particle){ .position = vec2(x, y), .mass = 1.0f, .color = BLACK, .radius = 2.0f };
+}
+
+// everything written since *cursor
+static int drain(struct ContactEvents *ce, uint64_t *cursor, struct ContactEvent *out) {
+    return contact_events_read(ce, cursor, out, 64);
+}
+
+static void step(struct ContactEvents *ce, const struct Particle *p, const int *ids, int n) {
+    contact_events_clear(ce);
+    contact_find_particles(ce, p, ids, n);
+    contact_events_commit(ce);
+}
+
+// ─── stable ids ──────────────────────────────────────────────────
+
+// events name particles by id, and moving them around in storage is not
+// a contact ending and another beginning
+static void test_ids_survive_reorder(void) {
+    struct ContactEvents ce;
+    CU_ASSERT_EQUAL_FATAL(contact_events_init(&ce, 64), 0);
+    uint64_t cursor = 0;
+    struct ContactEvent ev[64];
+
+    struct Particle p[3] = { at(0, 0), at(3, 0), at(100, 100) };
+    int ids[3] = { 10, 3, 7 };
+    step(&ce, p, ids, 3);
+    CU_ASSERT_EQUAL_FATAL(drain(&ce, &cursor, ev), 1);
+    CU_ASSERT_EQUAL(ev[0].kind, CONTACT_BEGIN);
+    CU_ASSERT_EQUAL(ev[0].a, 3);
+    CU_ASSERT_EQUAL(ev[0].b, 10);
+
+    // reversed storage, same particles
+    struct Particle q[3] = { p[2], p[1], p[0] };
+    int qids[3] = { 7, 3, 10 };
+    step(&ce, q, qids, 3);
+    CU_ASSERT_EQUAL_FATAL(drain(&ce, &cursor, ev), 1);
+    CU_ASSERT_EQUAL(ev[0].kind, CONTACT_PERSIST);
+    CU_ASSERT_EQUAL(ev[0].a, 3);
+    CU_ASSERT_EQUAL(ev[0].b, 10);
+    contact_events_free(&ce);
+}
+
+// ─── removal ─────────────────────────────────────────────────────
+
+// a despawned particle's pairs end right away, and the next step has
+// nothing left to say about them
+static void test_remove_emits_end(void) {
+    struct ContactEvents ce;
+    CU_ASSERT_EQUAL_FATAL(contact_events_init(&ce, 64), 0);
+    uint64_t cursor = 0;
+    struct ContactEvent ev[64];
+
+    struct Particle p[3] = { at(0, 0), at(3, 0), at(6, 0) };
+    int ids[3] = { 0, 1, 2 };
+    step(&ce, p, ids, 3);
+    CU_ASSERT_EQUAL(drain(&ce, &cursor, ev), 2); // 0-1, 1-2
+
+    // id 1 is gone
+    int index_of[3] = { 0, -1, 1 };
+    contact_events_remove(&ce, index_of);
+    int got = drain(&ce, &cursor, ev);
+    CU_ASSERT_EQUAL_FATAL(got, 2);
+    for (int k = 0; k < got; k++) {
+        CU_ASSERT_EQUAL(ev[k].kind, CONTACT_END);
+        CU_ASSERT_TRUE(ev[k].a == 1 || ev[k].b == 1);
+    }
+
+    struct Particle q[2] = { p[0], p[2] };
+    int qids[2] = { 0, 2 };
+    step(&ce, q, qids, 2);
+    CU_ASSERT_EQUAL(drain(&ce, &cursor, ev), 0);
+    contact_events_free(&ce);
+}
+
+// remap ends pairs with a removed particle too, and keeps wall pairs
+static void test_remap_emits_end(void) {
+    struct ContactEvents ce;
+    CU_ASSERT_EQUAL_FATAL(contact_events_init(&ce, 64), 0);
+    uint64_t cursor = 0;
+    struct ContactEvent ev[64];
+
+    contact_events_clear(&ce);
+    contact_events_add(&ce, 0, 1);
+    contact_events_add(&ce, 2, CONTACT_STATIC | 5);
+    contact_events_add(&ce, 1, CONTACT_STATIC | 4);
+    contact_events_commit(&ce);
+    CU_ASSERT_EQUAL(drain(&ce, &cursor, ev), 3);
+
+    int remap[3] = { 1, -1, 0 };
+    contact_events_remap(&ce, remap);
+    int got = drain(&ce, &cursor, ev);
+    CU_ASSERT_EQUAL_FATAL(got, 2);
+    int ends = 0;
+    for (int k = 0; k < got; k++)
+        ends += ev[k].kind == CONTACT_END && ev[k].a <= 1 && (ev[k].b == 1 || ev[k].b == (CONTACT_STATIC | 4));
+    CU_ASSERT_EQUAL(ends, 2);
+
+    // the wall pair moved to the new index and carries on
+    contact_events_clear(&ce);
+    contact_events_add(&ce, 0, CONTACT_STATIC | 5);
+    contact_events_commit(&ce);
+    CU_ASSERT_EQUAL_FATAL(drain(&ce, &cursor, ev), 1);
+    CU_ASSERT_EQUAL(ev[0].kind, CONTACT_PERSIST);
+    CU_ASSERT_EQUAL(ev[0].a, 0);
+    CU_ASSERT_EQUAL(ev[0].b, CONTACT_STATIC | 5);
+    contact_events_free(&ce);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s = CU_add_suite("contact_events", NULL, NULL);
+    CU_add_test(s, "ids_survive_reorder", test_ids_survive_reorder);
+    CU_add_test(s, "remove_emits_end",    test_remove_emits_end);
+    CU_add_test(s, "remap_emits_end",     test_remap_emits_end);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
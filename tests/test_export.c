@@ -0,0 +1,193 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/export.h"
+
+#define N 2000
+#define FRAMES 20000
+
+static char name[64];
+
+// particle i of frame f is at (f, i) moving at (f, -f)
+static void fill(struct Particle *p, int n, uint64_t f) {
+    for (int i = 0; i < n; i++) {
+        p[i].position = vec2((float)f, (float)i);
+        p[i].linear_velocity = vec2((float)f, -(float)f);
+    }
+}
+
+// ─── basics ──────────────────────────────────────────────────────
+
+static void test_publish_and_read(void) {
+    static struct Particle p[N];
+    struct Exporter ex;
+    struct ExportReader rd;
+    const struct ExportFrame *f;
+    CU_ASSERT_EQUAL_FATAL(export_create(&ex, name, 4, N), 0);
+    CU_ASSERT_EQUAL_FATAL(export_open(&rd, name), 0);
+    CU_ASSERT_EQUAL(export_read_latest(&rd, &f), 0);
+
+    fill(p, N, 1);
+    export_publish(&ex, p, N, 0.5);
+    CU_ASSERT_EQUAL_FATAL(export_read_latest(&rd, &f), 1);
+    CU_ASSERT_EQUAL(f->number, 1);
+    CU_ASSERT_EQUAL(f->count, N);
+    CU_ASSERT_DOUBLE_EQUAL(f->time, 0.5, 0);
+    CU_ASSERT_DOUBLE_EQUAL(export_position(&rd, f, 7).y, 7, 0);
+    CU_ASSERT_DOUBLE_EQUAL(export_velocity(&rd, f, 7).y, -1, 0);
+
+    // decimated frames hold every d-th particle
+    ex.decimate = 3;
+    fill(p, N, 2);
+    export_publish(&ex, p, N, 1.0);
+    CU_ASSERT_EQUAL_FATAL(export_read_latest(&rd, &f), 1);
+    CU_ASSERT_EQUAL(f->count, (N + 2) / 3);
+    CU_ASSERT_DOUBLE_EQUAL(export_position(&rd, f, 5).y, 15, 0);
+
+    export_close(&rd);
+    export_destroy(&ex);
+}
+
+// ─── creating over an existing name ──────────────────────────────
+
+// a second writer must not pull the name out from under a live one
+static void test_live_writer_kept(void) {
+    static struct Particle p[N];
+    struct Exporter ex, other;
+    struct ExportReader rd;
+    const struct ExportFrame *f;
+    CU_ASSERT_EQUAL_FATAL(export_create(&ex, name, 4, N), 0);
+    CU_ASSERT_EQUAL_FATAL(export_open(&rd, name), 0);
+
+    errno = 0;
+    CU_ASSERT_EQUAL(export_create(&other, name, 4, N), -1);
+    CU_ASSERT_EQUAL(errno, EEXIST);
+
+    // the reader still sees the first writer's frames
+    fill(p, N, 1);
+    export_publish(&ex, p, N, 0.0);
+    CU_ASSERT_EQUAL(export_read_latest(&rd, &f), 1);
+    export_close(&rd);
+
+    // and a fresh reader still finds it under the name
+    CU_ASSERT_EQUAL_FATAL(export_open(&rd, name), 0);
+    CU_ASSERT_EQUAL(export_read_latest(&rd, &f), 1);
+    export_close(&rd);
+    export_destroy(&ex);
+}
+
+// a writer that died without export_destroy leaves its object behind,
+// the next create replaces it
+static void test_stale_object_replaced(void) {
+    pid_t child = fork();
+    if (child == 0) {
+        struct Exporter ex;
+        _exit(export_create(&ex, name, 2, 16) ? 1 : 0);
+    }
+    int status = 0;
+    CU_ASSERT_EQUAL_FATAL(waitpid(child, &status, 0), child);
+    CU_ASSERT_EQUAL_FATAL(WEXITSTATUS(status), 0);
+
+    struct Exporter ex;
+    CU_ASSERT_EQUAL_FATAL(export_create(&ex, name, 4, N), 0);
+    CU_ASSERT_EQUAL(ex.header->max_particles, N);
+    export_destroy(&ex);
+}
+
+// ─── seqlock ─────────────────────────────────────────────────────
+
+struct Stress {
+    struct Exporter *ex;
+    int done;
+    long reads, torn, backwards, lapped;
+};
+
+static void *write_frames(void *arg) {
+    struct Stress *s = arg;
+    static struct Particle p[N];
+    for (uint64_t f = 1; f <= FRAMES; f++) {
+        fill(p, N, f);
+        export_publish(s->ex, p, N, (double)f);
+    }
+    __atomic_store_n(&s->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// every record of a frame has to come from that frame
+static void *read_frames(void *arg) {
+    struct Stress *s = arg;
+    struct ExportReader rd;
+    if (export_open(&rd, name)) return NULL;
+    uint64_t last = 0;
+    while (!__atomic_load_n(&s->done, __ATOMIC_ACQUIRE)) {
+        const struct ExportFrame *f;
+        int r = export_read_latest(&rd, &f);
+        if (r < 0) s->lapped++;
+        if (r <= 0) continue;
+        s->reads++;
+        if (f->number < last) s->backwards++;
+        last = f->number;
+
+        int ok = f->count == N && f->time == (double)f->number;
+        for (uint32_t i = 0; i < f->count && ok; i++) {
+            Vec2 pos = export_position(&rd, f, i), vel = export_velocity(&rd, f, i);
+            ok = pos.x == (float)f->number && pos.y == (float)i && vel.y == -(float)f->number;
+        }
+        if (!ok) s->torn++;
+    }
+    export_close(&rd);
+    return NULL;
+}
+
+static void test_reader_never_sees_torn_frame(void) {
+    struct Exporter ex;
+    CU_ASSERT_EQUAL_FATAL(export_create(&ex, name, 2, N), 0);
+
+    // two slots so the writer is back in the slot being read all the time
+    struct Stress s = {&ex, 0, 0, 0, 0, 0};
+    pthread_t writer, reader;
+    pthread_create(&reader, NULL, read_frames, &s);
+    pthread_create(&writer, NULL, write_frames, &s);
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+
+    printf("\n    %ld reads, %ld lapped\n", s.reads, s.lapped);
+    CU_ASSERT_TRUE(s.reads > 0);
+    CU_ASSERT_EQUAL(s.torn, 0);
+    CU_ASSERT_EQUAL(s.backwards, 0);
+    export_destroy(&ex);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    snprintf(name, sizeof(name), "/physics_test_export_%d", (int)getpid());
+
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("export", NULL, NULL);
+    CU_add_test(s1, "publish_read", test_publish_and_read);
+    CU_add_test(s1, "live_writer",  test_live_writer_kept);
+    CU_add_test(s1, "stale_object", test_stale_object_replaced);
+
+    CU_pSuite s2 = CU_add_suite("export_seqlock", NULL, NULL);
+    CU_add_test(s2, "no_torn_frames", test_reader_never_sees_torn_frame);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
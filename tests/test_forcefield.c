@@ -0,0 +1,181 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/forcefield.h"
+#include "engine/rng.h"
+
+#define N 257 // not a multiple of anything
+#define DT (1.0f / 60.0f)
+
+FORCE_FIELD_KERNEL(kernel_attract_drag, FORCE_FIELD_BIT(ATTRACT) | FORCE_FIELD_BIT(DRAG))
+FORCE_FIELD_KERNEL(kernel_drag_only, FORCE_FIELD_BIT(DRAG))
+FORCE_FIELD_KERNEL(kernel_all, FORCE_FIELD_ALL)
+
+static void random_particles(struct Particle *p, int n, uint64_t seed) {
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    for (int i = 0; i < n; i++) {
+        p[i] = (struct Particle){
+            .position = vec2(rng_range(&rng, 0, 800), rng_range(&rng, 0, 600)),
+            .linear_velocity = vec2(rng_range(&rng, -50, 50), rng_range(&rng, -50, 50)),
+            .mass = rng_range(&rng, 0.5f, 4.0f),
+            .color = BLACK,
+            .radius = 2.0f,
+        };
+    }
+}
+
+static int close_to(Vec2 a, Vec2 b) {
+    float scale = fmaxf(1.0f, fmaxf(vec2_len(a), vec2_len(b)));
+    return vec2_len(vec2_sub(a, b)) <= 1e-5f * scale;
+}
+
+static int all_close(const struct Particle *a, const struct Particle *b, int n) {
+    for (int i = 0; i < n; i++)
+        if (!close_to(a[i].position, b[i].position) ||
+            !close_to(a[i].linear_velocity, b[i].linear_velocity)) return 0;
+    return 1;
+}
+
+// ─── fused kernel vs particle_* ──────────────────────────────────
+
+// the kernel gives drag the start of step velocity, so the old helpers run
+// drag first. attract only looks at the position, that order is exact
+static void test_kernel_matches_helpers(void) {
+    static struct Particle fused[N], ref[N];
+    random_particles(fused, N, 1);
+    for (int i = 0; i < N; i++) ref[i] = fused[i];
+
+    struct ForceFieldList list = {0};
+    force_fields_add(&list, force_field_attract(vec2(400, 300), 5000.0f));
+    force_fields_add(&list, force_field_drag(0.2f));
+
+    for (int step = 0; step < 10; step++) {
+        kernel_attract_drag(&list, fused, NULL, N, DT);
+        for (int i = 0; i < N; i++) {
+            particle_drag(&ref[i], 0.2f);
+            particle_attract(&ref[i], vec2(400, 300), 5000.0f);
+            particle_update(&ref[i], DT);
+        }
+    }
+    CU_ASSERT_TRUE(all_close(fused, ref, N));
+}
+
+static void test_kernel_mask_skips_fields(void) {
+    static struct Particle fused[N], ref[N];
+    random_particles(fused, N, 2);
+    for (int i = 0; i < N; i++) ref[i] = fused[i];
+
+    struct ForceFieldList list = {0};
+    force_fields_add(&list, force_field_attract(vec2(100, 100), 1e6f)); // not in the mask
+    force_fields_add(&list, force_field_drag(0.5f));
+
+    kernel_drag_only(&list, fused, NULL, N, DT);
+    for (int i = 0; i < N; i++) {
+        particle_drag(&ref[i], 0.5f);
+        particle_update(&ref[i], DT);
+    }
+    CU_ASSERT_TRUE(all_close(fused, ref, N));
+}
+
+static void test_kernel_adds_pair_forces(void) {
+    static struct Particle fused[N], ref[N];
+    static Vec2 forces[N];
+    random_particles(fused, N, 3);
+    for (int i = 0; i < N; i++) ref[i] = fused[i];
+
+    struct ForceFieldList list = {0};
+    force_fields_add(&list, force_field_gravity(vec2(0, 9.8f)));
+    for (int i = 0; i < N; i++) forces[i] = vec2((float)i, -(float)i);
+    kernel_all(&list, fused, forces, N, DT);
+    for (int i = 0; i < N; i++) {
+        particle_force(&ref[i], vec2((float)i, -(float)i));
+        particle_gravity(&ref[i], vec2(0, 9.8f));
+        particle_update(&ref[i], DT);
+    }
+    CU_ASSERT_TRUE(all_close(fused, ref, N));
+}
+
+// ─── per kind laws ───────────────────────────────────────────────
+
+static void test_pull_and_gravity_point(void) {
+    static struct Particle fused[N], ref[N];
+    random_particles(fused, N, 4);
+    for (int i = 0; i < N; i++) ref[i] = fused[i];
+
+    Vec2 point = vec2(420, 310);
+    struct ForceFieldList list = {0};
+    force_fields_add(&list, force_field_pull(point, 10.0f));
+    force_fields_add(&list, force_field_gravity_point(point, 50.0f, 0.1f, 120.0f));
+
+    kernel_all(&list, fused, NULL, N, DT);
+    for (int i = 0; i < N; i++) {
+        float dist = vec2_len(vec2_sub(point, ref[i].position));
+        particle_attract(&ref[i], point, 10.0f * dist);
+        particle_gravity_point(&ref[i], point, 50.0f, 0.1f, 120.0f);
+        particle_update(&ref[i], DT);
+    }
+    CU_ASSERT_TRUE(all_close(fused, ref, N));
+}
+
+// buckets reorder the fields by kind, the sum has to stay the same
+static void test_buckets_sum_every_field(void) {
+    static struct Particle p[N];
+    random_particles(p, N, 5);
+
+    struct ForceFieldList list = {0};
+    force_fields_add(&list, force_field_attract(vec2(10, 20), 300.0f));
+    force_fields_add(&list, force_field_drag(0.3f));
+    force_fields_add(&list, force_field_gravity(vec2(1, 2)));
+    force_fields_add(&list, force_field_attract(vec2(700, 500), -80.0f));
+    force_fields_add(&list, force_field_drag(0.1f));
+
+    struct ForceFieldBuckets all, drag_only;
+    force_fields_bucket(&list, FORCE_FIELD_ALL, &all);
+    force_fields_bucket(&list, FORCE_FIELD_BIT(DRAG), &drag_only);
+    CU_ASSERT_EQUAL(all.count[FORCE_FIELD_ATTRACT], 2);
+    CU_ASSERT_EQUAL(all.count[FORCE_FIELD_DRAG], 2);
+    CU_ASSERT_EQUAL(all.count[FORCE_FIELD_GRAVITY], 1);
+    CU_ASSERT_EQUAL(drag_only.count[FORCE_FIELD_ATTRACT], 0);
+
+    int ok = 1;
+    for (int i = 0; i < N; i++) {
+        Vec2 ref = vec2(0, 0), drag = vec2(0, 0);
+        ref = vec2_add(ref, force_field_eval_attract(&list.fields[0], &p[i]));
+        ref = vec2_add(ref, force_field_eval_drag(&list.fields[1], &p[i]));
+        ref = vec2_add(ref, force_field_eval_gravity(&list.fields[2], &p[i]));
+        ref = vec2_add(ref, force_field_eval_attract(&list.fields[3], &p[i]));
+        ref = vec2_add(ref, force_field_eval_drag(&list.fields[4], &p[i]));
+        drag = vec2_add(force_field_eval_drag(&list.fields[1], &p[i]),
+                        force_field_eval_drag(&list.fields[4], &p[i]));
+        ok &= close_to(force_fields_sum(&all, FORCE_FIELD_ALL, &p[i]), ref);
+        ok &= close_to(force_fields_sum(&drag_only, FORCE_FIELD_BIT(DRAG), &p[i]), drag);
+    }
+    CU_ASSERT_TRUE(ok);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("force_field_kernel", NULL, NULL);
+    CU_add_test(s1, "matches_helpers", test_kernel_matches_helpers);
+    CU_add_test(s1, "mask_skips",      test_kernel_mask_skips_fields);
+    CU_add_test(s1, "pair_forces",     test_kernel_adds_pair_forces);
+
+    CU_pSuite s2 = CU_add_suite("force_field_laws", NULL, NULL);
+    CU_add_test(s2, "pull_gravity_point", test_pull_and_gravity_point);
+    CU_add_test(s2, "buckets",            test_buckets_sum_every_field);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "engine/job.h"
+#include "engine/parallel.h"
+
+// ─── parallel_for ────────────────────────────────────────────────
+
+struct Hits {
+    int *hits;
+    int inner; // > 0 runs a nested parallel_for of this size per item
+};
+
+static void count_inner(void *ctx, int begin, int end) {
+    int *sum = ctx;
+    __atomic_add_fetch(sum, end - begin, __ATOMIC_RELAXED);
+}
+
+static void count_range(void *ctx, int begin, int end) {
+    struct Hits *h = ctx;
+    for (int i = begin; i < end; i++) {
+        if (h->inner) {
+            int sum = 0;
+            parallel_for(h->inner, 7, count_inner, &sum);
+            if (sum != h->inner) continue; // shows up as a missed index
+        }
+        __atomic_add_fetch(&h->hits[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+static int every_index_once(int count, int grain, int inner) {
+    struct Hits h = {calloc(count, sizeof(int)), inner};
+    parallel_for(count, grain, count_range, &h);
+    int ok = 1;
+    for (int i = 0; i < count; i++) ok &= h.hits[i] == 1;
+    free(h.hits);
+    return ok;
+}
+
+static void test_parallel_for_covers_range(void) {
+    CU_ASSERT_TRUE(every_index_once(1, 1, 0));
+    CU_ASSERT_TRUE(every_index_once(1000, 1, 0));
+    CU_ASSERT_TRUE(every_index_once(1000, 64, 0));
+    CU_ASSERT_TRUE(every_index_once(100003, 1000, 0));
+}
+
+static void test_parallel_for_nested(void) {
+    CU_ASSERT_TRUE(every_index_once(64, 1, 500));
+}
+
+static void test_parallel_for_thread_counts(void) {
+    for (int t = 1; t <= 8; t *= 2) {
+        parallel_set_thread_count(t);
+        CU_ASSERT_EQUAL(parallel_thread_count(), t);
+        CU_ASSERT_TRUE(every_index_once(5000, 16, 0));
+    }
+    parallel_set_thread_count(0);
+}
+
+// ─── task graph ──────────────────────────────────────────────────
+
+struct Stamp {
+    int *clock;
+    int at;
+};
+
+static void stamp(void *ctx) {
+    struct Stamp *s = ctx;
+    s->at = __atomic_add_fetch(s->clock, 1, __ATOMIC_SEQ_CST);
+}
+
+// a -> (b, c) -> d, over and over
+static void test_graph_diamond(void) {
+    parallel_set_thread_count(4);
+    int ordered = 1;
+    for (int round = 0; round < 500; round++) {
+        int clock = 0;
+        struct Stamp sa = {&clock, 0}, sb = {&clock, 0}, sc = {&clock, 0}, sd = {&clock, 0};
+        struct Job a, b, c, d;
+        struct JobCounter done = {0};
+        job_init(&a, stamp, &sa);
+        job_init(&b, stamp, &sb);
+        job_init(&c, stamp, &sc);
+        job_init(&d, stamp, &sd);
+        job_depends(&b, &a);
+        job_depends(&c, &a);
+        job_depends(&d, &b);
+        job_depends(&d, &c);
+
+        // submit in reverse so nothing relies on submit order
+        job_submit(&d, &done);
+        job_submit(&c, &done);
+        job_submit(&b, &done);
+        job_submit(&a, &done);
+        job_wait(&done);
+
+        ordered &= done.value == 0 && sa.at == 1 && sb.at > 1 && sc.at > 1 && sd.at == 4;
+    }
+    CU_ASSERT_TRUE(ordered);
+    parallel_set_thread_count(0);
+}
+
+static void test_graph_successor_limit(void) {
+    struct Job root, leaves[JOB_MAX_SUCCESSORS + 1];
+    job_init(&root, stamp, NULL);
+    for (int i = 0; i < JOB_MAX_SUCCESSORS; i++) {
+        job_init(&leaves[i], stamp, NULL);
+        CU_ASSERT_EQUAL(job_depends(&leaves[i], &root), 0);
+    }
+    job_init(&leaves[JOB_MAX_SUCCESSORS], stamp, NULL);
+    CU_ASSERT_EQUAL(job_depends(&leaves[JOB_MAX_SUCCESSORS], &root), -1);
+}
+
+static void bump(void *ctx) {
+    __atomic_add_fetch((int *)ctx, 1, __ATOMIC_RELAXED);
+}
+
+// more jobs than a deque or the inbox holds
+static void test_many_jobs(void) {
+    enum { N = 5000 };
+    static struct Job jobs[N];
+    int ran = 0;
+    struct JobCounter done = {0};
+    for (int i = 0; i < N; i++) {
+        job_init(&jobs[i], bump, &ran);
+        job_submit(&jobs[i], &done);
+    }
+    job_wait(&done);
+    CU_ASSERT_EQUAL(ran, N);
+}
+
+// ─── thread counts ───────────────────────────────────────────────
+
+// uneven work over several thread counts, including more threads than
+// cores, gives the same answers as one thread. timing lives in bench/bench_job
+struct Work {
+    int skewed;
+    double *out;
+};
+
+static void burn(void *ctx, int begin, int end) {
+    struct Work *w = ctx;
+    for (int i = begin; i < end; i++) {
+        int iters = w->skewed ? i % 97 : 16;
+        double x = i;
+        for (int k = 0; k < iters; k++) x = sqrt(x + k);
+        w->out[i] = x;
+    }
+}
+
+static void test_results_match_across_threads(void) {
+    enum { ITEMS = 2048 };
+    static double want[ITEMS], got[ITEMS];
+    for (int skewed = 0; skewed <= 1; skewed++) {
+        parallel_set_thread_count(1);
+        parallel_for(ITEMS, 16, burn, &(struct Work){skewed, want});
+        for (int t = 2; t <= 16; t *= 2) {
+            parallel_set_thread_count(t);
+            for (int i = 0; i < ITEMS; i++) got[i] = -1.0;
+            parallel_for(ITEMS, 16, burn, &(struct Work){skewed, got});
+            int same = 1;
+            for (int i = 0; i < ITEMS; i++)
+                if (got[i] != want[i]) same = 0;
+            CU_ASSERT_TRUE(same);
+        }
+    }
+    parallel_set_thread_count(0);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    // parallel_for
+    CU_pSuite s1 = CU_add_suite("parallel_for", NULL, NULL);
+    CU_add_test(s1, "covers_range",  test_parallel_for_covers_range);
+    CU_add_test(s1, "nested",        test_parallel_for_nested);
+    CU_add_test(s1, "thread_counts", test_parallel_for_thread_counts);
+
+    // task graph
+    CU_pSuite s2 = CU_add_suite("job_graph", NULL, NULL);
+    CU_add_test(s2, "diamond",         test_graph_diamond);
+    CU_add_test(s2, "successor_limit", test_graph_successor_limit);
+    CU_add_test(s2, "many_jobs",       test_many_jobs);
+
+    // thread counts
+    CU_pSuite s3 = CU_add_suite("job_threads", NULL, NULL);
+    CU_add_test(s3, "results_match", test_results_match_across_threads);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    job_shutdown();
+    return failures ? 1 : 0;
+}
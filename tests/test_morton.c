@@ -0,0 +1,233 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/morton.h"
+#include "engine/rng.h"
+#include "engine/job.h"
+
+#define N 5000 // a few radix blocks
+
+// mass carries the original index, exact for n < 2^24
+static void random_particles(struct Particle *p, int n, uint64_t seed) {
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    for (int i = 0; i < n; i++) {
+        p[i] = (struct Particle){ .position = vec2(rng_range(&rng, -300, 900), rng_range(&rng, 0, 600)),
+                                  .linear_velocity = vec2(0, 0), .mass = (float)i,
+                                  .color = BLACK, .radius = 1.0f };
+    }
+}
+
+// the morton key the sort used for p, same quantization as morton.c
+static int keys_sorted(const struct Particle *p, int n) {
+    Vec2 lo = p[0].position, hi = lo;
+    for (int i = 1; i < n; i++) {
+        lo = vec2(fminf(lo.x, p[i].position.x), fminf(lo.y, p[i].position.y));
+        hi = vec2(fmaxf(hi.x, p[i].position.x), fmaxf(hi.y, p[i].position.y));
+    }
+    float scale = 65535.0f / fmaxf(hi.x - lo.x, hi.y - lo.y);
+    uint32_t prev = 0;
+    for (int i = 0; i < n; i++) {
+        Vec2 d = vec2_sub(p[i].position, lo);
+        float fx = d.x * scale, fy = d.y * scale;
+        uint32_t x = fx <= 0.0f ? 0 : fx >= 65535.0f ? 65535 : (uint32_t)fx;
+        uint32_t y = fy <= 0.0f ? 0 : fy >= 65535.0f ? 65535 : (uint32_t)fy;
+        uint32_t k = morton_encode(x, y);
+        if (k < prev) return 0;
+        prev = k;
+    }
+    return 1;
+}
+
+// ─── morton_encode ───────────────────────────────────────────────
+
+static void test_encode_interleaves(void) {
+    CU_ASSERT_EQUAL(morton_encode(0, 0), 0u);
+    CU_ASSERT_EQUAL(morton_encode(1, 0), 1u);
+    CU_ASSERT_EQUAL(morton_encode(0, 1), 2u);
+    CU_ASSERT_EQUAL(morton_encode(3, 3), 15u);
+    CU_ASSERT_EQUAL(morton_encode(0xffff, 0), 0x55555555u);
+    CU_ASSERT_EQUAL(morton_encode(0, 0xffff), 0xaaaaaaaau);
+}
+
+// ─── reorder ─────────────────────────────────────────────────────
+
+static void test_reorder_is_permutation(void) {
+    static struct Particle p[N];
+    static int seen[N];
+    struct MortonSort m;
+    random_particles(p, N, 1);
+    CU_ASSERT_EQUAL_FATAL(morton_init(&m, N), 0);
+    CU_ASSERT_EQUAL(morton_reorder(&m, p, N), 0);
+
+    int ok = 1;
+    for (int i = 0; i < N; i++) seen[i] = 0;
+    for (int i = 0; i < N; i++) {
+        int old = m.perm[i];
+        if (old < 0 || old >= N || seen[old]++) ok = 0;
+        else if ((int)p[i].mass != old || m.remap[old] != i) ok = 0;
+    }
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_TRUE(keys_sorted(p, N));
+    morton_free(&m);
+}
+
+// ids follow particles through several reorders, index_of is their inverse
+static void test_ids_follow_particles(void) {
+    static struct Particle p[N];
+    struct MortonSort m;
+    random_particles(p, N, 2);
+    CU_ASSERT_EQUAL_FATAL(morton_init(&m, N), 0);
+
+    struct Rng rng;
+    rng_seed(&rng, 9, 0);
+    int ok = 1;
+    for (int round = 0; round < 4; round++) {
+        CU_ASSERT_EQUAL(morton_reorder(&m, p, N), 0);
+        for (int i = 0; i < N; i++) {
+            if (m.ids[i] != (int)p[i].mass || m.index_of[m.ids[i]] != i) ok = 0;
+        }
+        // scramble so the next sort has real work
+        for (int i = 0; i < N; i++)
+            p[i].position = vec2(rng_range(&rng, 0, 800), rng_range(&rng, 0, 600));
+    }
+    CU_ASSERT_TRUE(ok);
+    morton_free(&m);
+}
+
+static void test_apply_follows_reorder(void) {
+    static struct Particle p[N];
+    static int tag[N];
+    struct MortonSort m;
+    random_particles(p, N, 3);
+    for (int i = 0; i < N; i++) tag[i] = i * 7;
+    CU_ASSERT_EQUAL_FATAL(morton_init(&m, N), 0);
+    CU_ASSERT_EQUAL(morton_reorder(&m, p, N), 0);
+    CU_ASSERT_EQUAL(morton_apply(&m, tag, sizeof(int)), 0);
+
+    int ok = 1;
+    for (int i = 0; i < N; i++)
+        if (tag[i] != (int)p[i].mass * 7) ok = 0;
+    CU_ASSERT_TRUE(ok);
+    morton_free(&m);
+}
+
+// ─── remove / append ─────────────────────────────────────────────
+
+static int drop_every_third(const struct Particle *p, void *ctx) {
+    (void)ctx;
+    return (int)p->mass % 3 == 0;
+}
+
+static int ids_consistent(const struct MortonSort *m, const struct Particle *p) {
+    for (int i = 0; i < m->count; i++)
+        if (m->ids[i] != (int)p[i].mass || m->index_of[m->ids[i]] != i) return 0;
+    return 1;
+}
+
+// removal compacts in storage order, survivors keep their ids
+static void test_remove_keeps_ids(void) {
+    static struct Particle p[N];
+    struct MortonSort m;
+    random_particles(p, N, 4);
+    CU_ASSERT_EQUAL_FATAL(morton_init(&m, N), 0);
+    CU_ASSERT_EQUAL(morton_reorder(&m, p, N), 0);
+
+    static int before[N];
+    for (int i = 0; i < N; i++) before[i] = (int)p[i].mass;
+    int n = morton_remove(&m, p, N, drop_every_third, NULL);
+    CU_ASSERT_EQUAL(n, N - (N + 2) / 3);
+    CU_ASSERT_EQUAL(m.count, n);
+    CU_ASSERT_TRUE(ids_consistent(&m, p));
+
+    int ok = 1, prev = -1;
+    for (int old = 0; old < N; old++) {
+        int gone = before[old] % 3 == 0;
+        if (gone != (m.remap[old] < 0)) ok = 0;
+        if (gone && m.index_of[before[old]] != -1) ok = 0;
+        if (!gone) {
+            if (m.remap[old] <= prev || (int)p[m.remap[old]].mass != before[old]) ok = 0;
+            prev = m.remap[old];
+        }
+    }
+    CU_ASSERT_TRUE(ok);
+    morton_free(&m);
+}
+
+// appends reuse removed ids before handing out new ones, and growing
+// keeps every id in place
+static void test_append_and_reserve(void) {
+    static struct Particle p[2 * N];
+    struct MortonSort m;
+    random_particles(p, N, 5);
+    CU_ASSERT_EQUAL_FATAL(morton_init(&m, N), 0);
+    int n = morton_remove(&m, p, N, drop_every_third, NULL);
+    int freed = N - n;
+
+    // the last removed id comes back first
+    int reused = m.free_ids[m.num_free - 1];
+    CU_ASSERT_EQUAL(morton_append(&m), reused);
+    p[n] = p[0];
+    p[n++].mass = (float)reused;
+    CU_ASSERT_EQUAL_FATAL(morton_reserve(&m, 2 * N), 0);
+    CU_ASSERT_EQUAL(m.capacity, 2 * N);
+    CU_ASSERT_TRUE(ids_consistent(&m, p));
+
+    // appended particles carry their id in mass
+    int ok = 1;
+    for (int k = 0; k < N; k++) {
+        int id = morton_append(&m);
+        if (id < 0 || id >= 2 * N) ok = 0;
+        p[n] = p[0];
+        p[n].mass = (float)id;
+        p[n].position = vec2(k % 100 * 8.0f, k / 100 * 6.0f);
+        n++;
+    }
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_EQUAL(m.num_free, 0);
+    CU_ASSERT_TRUE(ids_consistent(&m, p));
+
+    // ids are unique and fit the capacity, since removed ones came back first
+    static unsigned char used[2 * N];
+    ok = 1;
+    for (int i = 0; i < n; i++)
+        if (used[m.ids[i]]++) ok = 0;
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_EQUAL(n, N - freed + 1 + N);
+
+    // and a sort afterwards still tracks them
+    CU_ASSERT_EQUAL(morton_reorder(&m, p, n), 0);
+    CU_ASSERT_TRUE(ids_consistent(&m, p));
+    morton_free(&m);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("morton_encode", NULL, NULL);
+    CU_add_test(s1, "interleaves", test_encode_interleaves);
+
+    CU_pSuite s2 = CU_add_suite("morton_reorder", NULL, NULL);
+    CU_add_test(s2, "permutation", test_reorder_is_permutation);
+    CU_add_test(s2, "ids",         test_ids_follow_particles);
+    CU_add_test(s2, "apply",       test_apply_follows_reorder);
+
+    CU_pSuite s3 = CU_add_suite("morton_ids", NULL, NULL);
+    CU_add_test(s3, "remove",         test_remove_keeps_ids);
+    CU_add_test(s3, "append_reserve", test_append_and_reserve);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    job_shutdown();
+    return failures ? 1 : 0;
+}
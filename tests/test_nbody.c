@@ -0,0 +1,97 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "engine/nbody.h"
+#include "engine/rng.h"
+
+#define N 1037 // several tiles plus a tail that is not a multiple of 8
+#define G 0.1f
+#define TARGET 120.0f
+
+static float x[N], y[N];
+
+static void random_positions(uint64_t seed) {
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    for (int i = 0; i < N; i++) {
+        x[i] = rng_range(&rng, 0, 800);
+        y[i] = rng_range(&rng, 0, 600);
+    }
+    x[N - 1] = x[0]; // coincident pair, skipped by both paths
+    y[N - 1] = y[0];
+}
+
+// summation order differs between the paths, so compare against the size
+// of the largest force rather than each value
+static int forces_close(const float *ax, const float *ay, const float *bx, const float *by, int n) {
+    float scale = 1.0f;
+    for (int i = 0; i < n; i++)
+        scale = fmaxf(scale, fmaxf(fabsf(ax[i]), fabsf(ay[i])));
+    for (int i = 0; i < n; i++)
+        if (fabsf(ax[i] - bx[i]) > 1e-4f * scale || fabsf(ay[i] - by[i]) > 1e-4f * scale) return 0;
+    return 1;
+}
+
+// ─── avx2 vs scalar ──────────────────────────────────────────────
+
+static void test_symmetric_kernel_matches_scalar(void) {
+    static float sx[N], sy[N], vx[N], vy[N];
+    for (int cutoff = 0; cutoff < 2; cutoff++) {
+        float radius = cutoff ? 150.0f : 1e4f;
+        random_positions(1 + cutoff);
+        nbody_spring_forces(x, y, sx, sy, N, G, TARGET, radius, 0);
+        nbody_spring_forces(x, y, vx, vy, N, G, TARGET, radius, 1);
+        CU_ASSERT_TRUE(forces_close(sx, sy, vx, vy, N));
+    }
+}
+
+static void test_active_kernel_matches_scalar(void) {
+    static float sx[N], sy[N], vx[N], vy[N];
+    static int idx[N];
+    int count = 0;
+    for (int i = 0; i < N; i += 5) idx[count++] = i;
+
+    random_positions(3);
+    nbody_spring_forces_on(x, y, idx, count, sx, sy, N, G, TARGET, 200.0f, 0);
+    nbody_spring_forces_on(x, y, idx, count, vx, vy, N, G, TARGET, 200.0f, 1);
+    CU_ASSERT_TRUE(forces_close(sx, sy, vx, vy, count));
+}
+
+// the active kernel on everyone is the symmetric kernel
+static void test_active_matches_symmetric(void) {
+    static float fx[N], fy[N], ax[N], ay[N];
+    static int idx[N];
+    for (int i = 0; i < N; i++) idx[i] = i;
+    random_positions(4);
+    nbody_spring_forces(x, y, fx, fy, N, G, TARGET, 200.0f, 1);
+    nbody_spring_forces_on(x, y, idx, N, ax, ay, N, G, TARGET, 200.0f, 1);
+    CU_ASSERT_TRUE(forces_close(fx, fy, ax, ay, N));
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("nbody", NULL, NULL);
+    CU_add_test(s1, "active_vs_symmetric", test_active_matches_symmetric);
+
+    // only meaningful where there is an avx2 path to compare
+    if (nbody_simd_supported()) {
+        CU_pSuite s2 = CU_add_suite("nbody_avx2", NULL, NULL);
+        CU_add_test(s2, "symmetric", test_symmetric_kernel_matches_scalar);
+        CU_add_test(s2, "active",    test_active_kernel_matches_scalar);
+    } else {
+        printf("no avx2, skipping the simd comparisons\n");
+    }
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/neighbor.h"
+#include "engine/rng.h"
+
+#define N 600
+#define CUTOFF 30.0f
+#define SKIN 6.0f
+
+static void random_particles(struct Particle *p, int n, Vec2 size, struct Rng *rng) {
+    for (int i = 0; i < n; i++) {
+        p[i] = (struct Particle){ .position = vec2(rng_range(rng, 0, size.x), rng_range(rng, 0, size.y)),
+                                  .linear_velocity = vec2(0, 0), .mass = 1.0f,
+                                  .color = BLACK, .radius = 1.0f };
+    }
+}
+
+// every pair inside cutoff is listed (once, or both ways when full), and
+// no row lists a particle twice
+static int matches_brute_force(const struct NeighborList *nl, const struct Particle *p, int n) {
+    static unsigned char listed[N][N];
+    memset(listed, 0, sizeof(listed));
+    for (int i = 0; i < n; i++) {
+        for (int k = nl->offsets[i]; k < nl->offsets[i + 1]; k++) {
+            int j = nl->indices[k];
+            if (j == i || (!nl->full && j < i) || listed[i][j]++) return 0;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            float d2 = vec2_len2(vec2_sub_periodic(p[j].position, p[i].position, nl->period));
+            if (d2 > CUTOFF * CUTOFF) continue;
+            if (!listed[i][j]) return 0;
+            if (nl->full && !listed[j][i]) return 0;
+        }
+    }
+    return 1;
+}
+
+// random walk, each step moves everyone by less than the skin so lists
+// get reused for a while. checks the list after every update
+static void walk(struct NeighborList *nl, struct Particle *p, Vec2 size, uint64_t seed,
+                 int *ok, int *reused) {
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    random_particles(p, N, size, &rng);
+    *ok = 1;
+    *reused = 0;
+    for (int step = 0; step < 40; step++) {
+        int r = neighbor_update(nl, p, N);
+        if (r < 0 || !matches_brute_force(nl, p, N)) *ok = 0;
+        if (r == 0) (*reused)++;
+        for (int i = 0; i < N; i++) {
+            Vec2 d = vec2(rng_range(&rng, -0.6f, 0.6f), rng_range(&rng, -0.6f, 0.6f));
+            p[i].position = vec2_add(p[i].position, d);
+            if (nl->period.x > 0.0f) p[i].position = vec2_wrap(p[i].position, nl->lo, nl->period);
+        }
+    }
+}
+
+// ─── open box ────────────────────────────────────────────────────
+
+static void test_half_list_with_reuse(void) {
+    static struct Particle p[N];
+    struct NeighborList nl;
+    neighbor_init(&nl, CUTOFF, SKIN);
+    int ok, reused;
+    walk(&nl, p, vec2(400, 300), 1, &ok, &reused);
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_TRUE(reused > 0);      // skin actually saved builds
+    CU_ASSERT_TRUE(nl.builds > 1);   // and moving past skin / 2 rebuilt
+    neighbor_free(&nl);
+}
+
+static void test_full_list_with_reuse(void) {
+    static struct Particle p[N];
+    struct NeighborList nl;
+    neighbor_init(&nl, CUTOFF, SKIN);
+    neighbor_set_full(&nl, 1);
+    int ok, reused;
+    walk(&nl, p, vec2(400, 300), 2, &ok, &reused);
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_TRUE(reused > 0);
+    neighbor_free(&nl);
+}
+
+// the list is only reused while nothing moved more than skin / 2
+static void test_rebuild_rule(void) {
+    static struct Particle p[N];
+    struct Rng rng;
+    rng_seed(&rng, 3, 0);
+    random_particles(p, N, vec2(400, 300), &rng);
+    struct NeighborList nl;
+    neighbor_init(&nl, CUTOFF, SKIN);
+    CU_ASSERT_EQUAL(neighbor_update(&nl, p, N), 1);
+
+    p[17].position.x += 0.49f * SKIN;
+    CU_ASSERT_EQUAL(neighbor_update(&nl, p, N), 0);
+    p[17].position.x += 0.02f * SKIN;
+    CU_ASSERT_EQUAL(neighbor_update(&nl, p, N), 1);
+
+    neighbor_invalidate(&nl);
+    CU_ASSERT_EQUAL(neighbor_update(&nl, p, N), 1);
+    neighbor_free(&nl);
+}
+
+// ─── periodic box ────────────────────────────────────────────────
+
+static void test_periodic_with_reuse(void) {
+    static struct Particle p[N];
+    for (int full = 0; full <= 1; full++) {
+        struct NeighborList nl;
+        neighbor_init(&nl, CUTOFF, SKIN);
+        neighbor_set_periodic(&nl, vec2(0, 0), vec2(300, 200));
+        neighbor_set_full(&nl, full);
+        int ok, reused;
+        walk(&nl, p, vec2(300, 200), 4 + full, &ok, &reused);
+        CU_ASSERT_TRUE(ok);
+        CU_ASSERT_TRUE(reused > 0);
+        neighbor_free(&nl);
+    }
+}
+
+// a box only a few cells wide, where neighbor cells wrap onto each other
+static void test_periodic_small_box(void) {
+    static struct Particle p[N];
+    struct NeighborList nl;
+    neighbor_init(&nl, CUTOFF, SKIN);
+    neighbor_set_periodic(&nl, vec2(0, 0), vec2(80, 160));
+    int ok, reused;
+    walk(&nl, p, vec2(80, 160), 6, &ok, &reused);
+    CU_ASSERT_TRUE(ok);
+    neighbor_free(&nl);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("neighbor_open", NULL, NULL);
+    CU_add_test(s1, "half_reuse",   test_half_list_with_reuse);
+    CU_add_test(s1, "full_reuse",   test_full_list_with_reuse);
+    CU_add_test(s1, "rebuild_rule", test_rebuild_rule);
+
+    CU_pSuite s2 = CU_add_suite("neighbor_periodic", NULL, NULL);
+    CU_add_test(s2, "reuse",     test_periodic_with_reuse);
+    CU_add_test(s2, "small_box", test_periodic_small_box);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "engine/app.h"
+#include "engine/contact.h"
+#include "engine/export.h"
+#include "engine/job.h"
+#include "engine/particle.h"
+#include "engine/nbody.h"
+#include "sim/particle.h"
+
+#define DT (1.0f / 60.0f)
+#define STEPS 120
+#define SEED 42
+
+static const AppConfig config = {800, 600, "test"};
+
+static Simulation make(int simd) {
+    struct ParticleParams params = particle_params_default();
+    params.simd = simd;
+    Simulation sim = particle_sim_with(&params, SEED);
+    if (sim.ctx) sim.init(sim.ctx, &config);
+    return sim;
+}
+
+static int same_particles(const Simulation *a, const Simulation *b) {
+    int na, nb;
+    const struct Particle *pa = particle_sim_particles(a, &na);
+    const struct Particle *pb = particle_sim_particles(b, &nb);
+    if (na != nb || na == 0) return 0;
+    for (int i = 0; i < na; i++) {
+        if (memcmp(&pa[i].position, &pb[i].position, sizeof(Vec2)) ||
+            memcmp(&pa[i].linear_velocity, &pb[i].linear_velocity, sizeof(Vec2))) return 0;
+    }
+    return 1;
+}
+
+// ─── instances ───────────────────────────────────────────────────
+
+// two sims with one seed, stepped in turn, never drift apart
+static void test_same_seed_side_by_side(void) {
+    Simulation a = make(1), b = make(1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(a.ctx);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(b.ctx);
+    CU_ASSERT_TRUE(same_particles(&a, &b));
+
+    int ok = 1;
+    for (int i = 0; i < STEPS; i++) {
+        a.physics(a.ctx, DT);
+        b.physics(b.ctx, DT);
+        ok &= same_particles(&a, &b);
+    }
+    CU_ASSERT_TRUE(ok);
+    a.destroy(a.ctx);
+    b.destroy(b.ctx);
+}
+
+// a sim stepped next to one with different settings ends up bit for bit
+// where it does alone, so nothing leaks between instances. with avx2 the
+// neighbor's scalar kernel is a different code path, without it the
+// neighbor still steps different params on the same kernels
+static void test_instances_independent(void) {
+    Simulation alone = make(1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(alone.ctx);
+    for (int i = 0; i < STEPS; i++) alone.physics(alone.ctx, DT);
+
+    Simulation a = make(1);
+    struct ParticleParams params = particle_params_default();
+    params.simd = 0;
+    params.G *= 2.0f;
+    Simulation other = particle_sim_with(&params, SEED + 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(a.ctx);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(other.ctx);
+    other.init(other.ctx, &config);
+    for (int i = 0; i < STEPS; i++) {
+        other.physics(other.ctx, DT);
+        a.physics(a.ctx, DT);
+    }
+    CU_ASSERT_TRUE(same_particles(&a, &alone));
+    CU_ASSERT_FALSE(same_particles(&a, &other));
+
+    alone.destroy(alone.ctx);
+    a.destroy(a.ctx);
+    other.destroy(other.ctx);
+}
+
+// the scalar and avx2 kernels sum in a different order, so a simd sim and
+// a scalar one part ways. they only match where there is no avx2
+static void test_simd_is_per_instance(void) {
+    Simulation vec = make(1), scalar = make(0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(vec.ctx);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(scalar.ctx);
+    for (int i = 0; i < STEPS; i++) {
+        vec.physics(vec.ctx, DT);
+        scalar.physics(scalar.ctx, DT);
+    }
+    if (nbody_simd_supported()) CU_ASSERT_FALSE(same_particles(&vec, &scalar));
+    else CU_ASSERT_TRUE(same_particles(&vec, &scalar));
+    vec.destroy(vec.ctx);
+    scalar.destroy(scalar.ctx);
+}
+
+// ─── step graph ──────────────────────────────────────────────────
+
+// contacts and the export are jobs after the integrate job, so both have
+// to see the particles where the step left them
+static void test_readers_see_the_stepped_particles(void) {
+    struct ParticleParams params = particle_params_default();
+    params.contacts = 1;
+    Simulation sim = particle_sim_with(&params, SEED);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(sim.ctx);
+
+    char name[64];
+    snprintf(name, sizeof(name), "/test_particle_%d", (int)getpid());
+    struct Exporter ex;
+    CU_ASSERT_EQUAL_FATAL(export_create(&ex, name, 4, params.num_particles + 64), 0);
+    particle_sim_set_exporter(&sim, &ex);
+    sim.init(sim.ctx, &config);
+
+    // a big slow cluster in the middle so there is something to touch
+    struct Command spawn[64];
+    for (int i = 0; i < 64; i++)
+        spawn[i] = command_spawn(vec2(400.0f + (i % 8) * 5.0f, 300.0f + (i / 8) * 5.0f), vec2(0, 0), 1.0f, 4.0f);
+    sim.apply(sim.ctx, spawn, 64);
+
+    struct ExportReader rd;
+    CU_ASSERT_EQUAL_FATAL(export_open(&rd, name), 0);
+
+    struct ContactEvents ref;
+    CU_ASSERT_EQUAL_FATAL(contact_events_init(&ref, 1024), 0);
+    int ok = 1, touching = 0;
+    for (int i = 0; i < STEPS; i++) {
+        sim.physics(sim.ctx, DT);
+        int n;
+        const struct Particle *p = particle_sim_particles(&sim, &n);
+        contact_events_clear(&ref);
+        contact_find_particles(&ref, p, NULL, n);
+        contact_events_commit(&ref);
+        const struct ContactEvents *ce = particle_sim_contacts(&sim);
+        ok &= ref.prev_count == ce->prev_count;
+        ok &= memcmp(ref.prev, ce->prev, (size_t)ref.prev_count * sizeof(uint64_t)) == 0;
+        touching += ref.prev_count;
+
+        // the newest frame holds this step's positions
+        const struct ExportFrame *f;
+        ok &= export_read_latest(&rd, &f) == 1 && f->count == (uint32_t)n;
+        for (int k = 0; ok && k < n; k++) {
+            Vec2 at = export_position(&rd, f, (uint32_t)k);
+            ok &= at.x == p[k].position.x && at.y == p[k].position.y;
+        }
+    }
+    CU_ASSERT_TRUE(ok);
+    CU_ASSERT_TRUE(touching > 0);
+    CU_ASSERT_EQUAL(ex.header->latest, (uint64_t)STEPS);
+
+    contact_events_free(&ref);
+    export_close(&rd);
+    export_destroy(&ex);
+    sim.destroy(sim.ctx);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("particle_instances", NULL, NULL);
+    CU_add_test(s1, "same_seed",   test_same_seed_side_by_side);
+    CU_add_test(s1, "independent", test_instances_independent);
+    CU_add_test(s1, "simd",        test_simd_is_per_instance);
+
+    CU_pSuite s2 = CU_add_suite("particle_step_graph", NULL, NULL);
+    CU_add_test(s2, "readers", test_readers_see_the_stepped_particles);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    job_shutdown();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/pm.h"
+#include "engine/job.h"
+
+#define SIZE 64
+#define EXTENT 640.0f // 10 px cells
+#define G 2.0f
+
+static struct Particle body(Vec2 p, float mass) {
+    return (struct Particle){ .position = p, .linear_velocity = vec2(0, 0),
+                              .mass = mass, .color = BLACK, .radius = 1.0f };
+}
+
+// |F| = G m1 m2 / r toward the other body. a periodic box also has the
+// neutralizing background (the k = 0 mode is dropped), which pushes back
+// with G m1 m2 pi r / L^2. the image lattice sums to nothing to first order
+static Vec2 direct(const struct Particle *a, const struct Particle *b, float period) {
+    Vec2 d = vec2_sub(b->position, a->position);
+    float background = period > 0.0f ? 3.14159265f / (period * period) : 0.0f;
+    return vec2_scale(d, G * a->mass * b->mass * (1.0f / vec2_len2(d) - background));
+}
+
+// relative error of the mesh force on both bodies against direct summation
+static float two_body_error(struct PmSolver *pm, Vec2 a, Vec2 b) {
+    struct Particle p[2] = { body(a, 3.0f), body(b, 5.0f) };
+    Vec2 f[2];
+    pm_forces(pm, p, 2, f);
+    Vec2 want = direct(&p[0], &p[1], pm->periodic ? EXTENT : 0.0f);
+    float err0 = vec2_len(vec2_sub(f[0], want)) / vec2_len(want);
+    float err1 = vec2_len(vec2_add(f[1], want)) / vec2_len(want);
+    return fmaxf(err0, err1);
+}
+
+// separations of several cells, where cloud in cell has converged
+static const Vec2 offsets[] = {
+    {80, 0}, {0, 120}, {60, 60}, {-90, 45}, {37, -101}, {150, 20},
+};
+#define NUM_OFFSETS ((int)(sizeof(offsets) / sizeof(offsets[0])))
+
+// ─── isolated ────────────────────────────────────────────────────
+
+static void test_isolated_two_body(void) {
+    struct PmSolver pm;
+    CU_ASSERT_EQUAL_FATAL(pm_init(&pm, SIZE, vec2(0, 0), EXTENT, G, 0), 0);
+    float worst = 0.0f;
+    for (int k = 0; k < NUM_OFFSETS; k++) {
+        Vec2 a = vec2(EXTENT * 0.5f - 0.3f * offsets[k].x + 3.3f, EXTENT * 0.5f - 0.3f * offsets[k].y + 1.7f);
+        worst = fmaxf(worst, two_body_error(&pm, a, vec2_add(a, offsets[k])));
+    }
+    CU_ASSERT_TRUE(worst < 0.05f);
+    pm_free(&pm);
+}
+
+// bodies outside an isolated domain neither feel nor pull anything, the
+// one inside only keeps its tiny cloud in cell self force
+static void test_isolated_outside(void) {
+    struct PmSolver pm;
+    CU_ASSERT_EQUAL_FATAL(pm_init(&pm, SIZE, vec2(0, 0), EXTENT, G, 0), 0);
+    struct Particle p[2] = { body(vec2(-50, 300), 1.0f), body(vec2(320, 300), 1.0f) };
+    Vec2 f[2];
+    pm_forces(&pm, p, 2, f);
+    CU_ASSERT_DOUBLE_EQUAL(vec2_len(f[0]), 0.0f, 1e-9f);
+    CU_ASSERT_DOUBLE_EQUAL(vec2_len(f[1]), 0.0f, 1e-5f);
+    pm_free(&pm);
+}
+
+// ─── periodic ────────────────────────────────────────────────────
+
+static void test_periodic_two_body(void) {
+    struct PmSolver pm;
+    CU_ASSERT_EQUAL_FATAL(pm_init(&pm, SIZE, vec2(0, 0), EXTENT, G, 1), 0);
+    float worst = 0.0f;
+    for (int k = 0; k < NUM_OFFSETS; k++) {
+        Vec2 a = vec2(200.0f + 7.1f * k, 310.0f - 5.3f * k);
+        worst = fmaxf(worst, two_body_error(&pm, a, vec2_add(a, offsets[k])));
+    }
+    CU_ASSERT_TRUE(worst < 0.05f);
+    pm_free(&pm);
+}
+
+// a pair straddling the box edge attracts across it, same as in the middle
+static void test_periodic_across_edge(void) {
+    struct PmSolver pm;
+    CU_ASSERT_EQUAL_FATAL(pm_init(&pm, SIZE, vec2(0, 0), EXTENT, G, 1), 0);
+    struct Particle p[2] = { body(vec2(EXTENT - 40, 300), 3.0f), body(vec2(40, 300), 5.0f) };
+    Vec2 f[2];
+    pm_forces(&pm, p, 2, f);
+    float want = G * 3.0f * 5.0f * (1.0f / 80.0f - 3.14159265f * 80.0f / (EXTENT * EXTENT));
+    CU_ASSERT_TRUE(f[0].x > 0.0f && f[1].x < 0.0f); // toward each other through the edge
+    CU_ASSERT_TRUE(fabsf(f[0].x - want) < 0.05f * want);
+    pm_free(&pm);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("pm_isolated", NULL, NULL);
+    CU_add_test(s1, "two_body", test_isolated_two_body);
+    CU_add_test(s1, "outside",  test_isolated_outside);
+
+    CU_pSuite s2 = CU_add_suite("pm_periodic", NULL, NULL);
+    CU_add_test(s2, "two_body",    test_periodic_two_body);
+    CU_add_test(s2, "across_edge", test_periodic_across_edge);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    job_shutdown();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <stdlib.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/render_lod.h"
+#include "engine/parallel.h"
+#include "engine/job.h"
+#include "engine/rng.h"
+
+#define WIDTH 320
+#define HEIGHT 200
+#define TEXEL 4
+
+enum { CULLED, SPLAT, CIRCLE };
+
+// the same rules as render_lod, one particle at a time
+static int classify(const struct RenderLod *r, const struct Particle *p, Vec2 origin, float scale) {
+    float x = (p->position.x - origin.x) * scale;
+    float y = (p->position.y - origin.y) * scale;
+    float rad = p->radius * scale;
+    if (rad < r->min_radius)
+        return x >= 0 && x < r->width && y >= 0 && y < r->height ? SPLAT : CULLED;
+    if (x + rad < 0 || x - rad > r->width || y + rad < 0 || y - rad > r->height) return CULLED;
+    return CIRCLE;
+}
+
+// particles spread over three times the view in each direction, half of
+// them too small to draw as circles
+static struct Particle *random_particles(int n, uint64_t seed) {
+    struct Particle *p = malloc(n * sizeof(struct Particle));
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    for (int i = 0; i < n; i++) {
+        p[i] = (struct Particle){ .position = vec2(rng_range(&rng, -WIDTH, 2 * WIDTH),
+                                                   rng_range(&rng, -HEIGHT, 2 * HEIGHT)),
+                                  .mass = 1.0f, .color = BLACK,
+                                  .radius = rng_range(&rng, 0.05f, 2.0f) };
+    }
+    return p;
+}
+
+// build once and compare everything against classify()
+static void check_build(int n, Vec2 origin, float scale, uint64_t seed) {
+    struct Particle *p = random_particles(n, seed);
+    struct RenderLod r;
+    CU_ASSERT_EQUAL_FATAL(render_lod_init(&r, WIDTH, HEIGHT, TEXEL), 0);
+    CU_ASSERT_EQUAL_FATAL(render_lod_build(&r, p, n, origin, scale), 0);
+
+    int circles = 0, splats = 0, culled = 0, order_ok = 1;
+    int *cells = calloc((size_t)r.grid_w * r.grid_h, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        switch (classify(&r, &p[i], origin, scale)) {
+        case CIRCLE:
+            // the circle list is exactly the circles, in storage order
+            if (circles >= r.num_circles || r.circles[circles] != i) order_ok = 0;
+            circles++;
+            break;
+        case SPLAT: {
+            int cx = (int)((p[i].position.x - origin.x) * scale / TEXEL);
+            int cy = (int)((p[i].position.y - origin.y) * scale / TEXEL);
+            cells[cy * r.grid_w + cx]++;
+            splats++;
+            break;
+        }
+        default:
+            culled++;
+        }
+    }
+    CU_ASSERT_TRUE(order_ok);
+    CU_ASSERT_EQUAL(r.num_circles, circles);
+    CU_ASSERT_EQUAL(r.splatted, splats);
+    CU_ASSERT_EQUAL(r.culled, culled);
+    CU_ASSERT_TRUE(circles > 0 && splats > 0 && culled > 0);
+
+    // heat shows exactly where splats landed, counts are cleared for the next build
+    int shaded_ok = 1, cleared_ok = 1;
+    for (int c = 0; c < r.grid_w * r.grid_h; c++) {
+        if ((r.pixels[c].a != 0) != (cells[c] != 0)) shaded_ok = 0;
+        if (r.density[c]) cleared_ok = 0;
+    }
+    CU_ASSERT_TRUE(shaded_ok);
+    CU_ASSERT_TRUE(cleared_ok);
+
+    free(cells);
+    render_lod_free(&r);
+    free(p);
+}
+
+// ─── classify ────────────────────────────────────────────────────
+
+static void test_small(void) {
+    check_build(2000, vec2(0, 0), 1.0f, 1);
+}
+
+static void test_panned_and_zoomed(void) {
+    check_build(2000, vec2(-50, 30), 2.5f, 2);
+    check_build(2000, vec2(100, -80), 0.75f, 3);
+}
+
+// enough particles for several blocks, which must still come out in order
+static void test_many_blocks(void) {
+    parallel_set_thread_count(4);
+    check_build(100000, vec2(10, 10), 1.0f, 4);
+    parallel_set_thread_count(0);
+}
+
+// a big circle whose center is off screen is still drawn, a small one isnt
+static void test_edges(void) {
+    struct Particle p[4] = {
+        { .position = vec2(-5, 100), .radius = 10, .mass = 1 },        // overlaps the left edge
+        { .position = vec2(-5, 100), .radius = 0.5f, .mass = 1 },      // splat off screen
+        { .position = vec2(WIDTH + 20, 100), .radius = 10, .mass = 1 },// fully off the right
+        { .position = vec2(WIDTH - 0.5f, HEIGHT - 0.5f), .radius = 0.5f, .mass = 1 }, // last cell
+    };
+    struct RenderLod r;
+    CU_ASSERT_EQUAL_FATAL(render_lod_init(&r, WIDTH, HEIGHT, TEXEL), 0);
+    CU_ASSERT_EQUAL_FATAL(render_lod_build(&r, p, 4, vec2(0, 0), 1.0f), 0);
+    CU_ASSERT_EQUAL(r.num_circles, 1);
+    CU_ASSERT_EQUAL(r.circles[0], 0);
+    CU_ASSERT_EQUAL(r.splatted, 1);
+    CU_ASSERT_EQUAL(r.culled, 2);
+    CU_ASSERT_NOT_EQUAL(r.pixels[r.grid_w * r.grid_h - 1].a, 0);
+    render_lod_free(&r);
+}
+
+// raising min_radius moves particles from circles to splats
+static void test_min_radius(void) {
+    struct Particle *p = random_particles(2000, 5);
+    struct RenderLod r;
+    CU_ASSERT_EQUAL_FATAL(render_lod_init(&r, WIDTH, HEIGHT, TEXEL), 0);
+    CU_ASSERT_EQUAL_FATAL(render_lod_build(&r, p, 2000, vec2(0, 0), 1.0f), 0);
+    int circles = r.num_circles, splats = r.splatted;
+    r.min_radius = 100.0f;
+    CU_ASSERT_EQUAL_FATAL(render_lod_build(&r, p, 2000, vec2(0, 0), 1.0f), 0);
+    CU_ASSERT_EQUAL(r.num_circles, 0);
+    CU_ASSERT_TRUE(r.splatted > splats);
+    CU_ASSERT_TRUE(r.splatted <= splats + circles);
+    render_lod_free(&r);
+    free(p);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s = CU_add_suite("render_lod", NULL, NULL);
+    CU_add_test(s, "small",       test_small);
+    CU_add_test(s, "pan_zoom",    test_panned_and_zoomed);
+    CU_add_test(s, "many_blocks", test_many_blocks);
+    CU_add_test(s, "edges",       test_edges);
+    CU_add_test(s, "min_radius",  test_min_radius);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+    job_shutdown();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,211 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "engine/scene.h"
+
+#define N 300
+
+static char path[] = "/tmp/test_scene_XXXXXX";
+
+static float px[N], py[N], vx[N], vy[N], mass[N], radius[N];
+static uint32_t color[N];
+static struct Line lines[3] = {
+    { {0, 0}, {100, 0} }, { {100, 0}, {100, 50} }, { {5, 5}, {6, 7} },
+};
+static struct Square squares[2] = {
+    { {50, 50}, 0.5f, 10, 20 }, { {70, 20}, 0.0f, 4, 4 },
+};
+
+static struct SceneDesc full_desc(void) {
+    for (int i = 0; i < N; i++) {
+        px[i] = i * 1.5f;
+        py[i] = i * -0.25f;
+        vx[i] = i % 7;
+        vy[i] = -(i % 5);
+        mass[i] = 1.0f + i;
+        radius[i] = 0.5f * (i % 3 + 1);
+        color[i] = 0xff000000u | (uint32_t)i;
+    }
+    return (struct SceneDesc){ N, px, py, vx, vy, mass, radius, color,
+                               3, 2, lines, squares, 800, 600 };
+}
+
+// overwrite one header field of the file at path
+static void patch(size_t offset, const void *data, size_t size) {
+    FILE *f = fopen(path, "r+b");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+    fseek(f, (long)offset, SEEK_SET);
+    fwrite(data, 1, size, f);
+    fclose(f);
+}
+
+// ─── round trip ──────────────────────────────────────────────────
+
+static void test_round_trip(void) {
+    struct SceneDesc d = full_desc();
+    CU_ASSERT_EQUAL_FATAL(scene_write(path, &d), 0);
+
+    struct Scene s;
+    CU_ASSERT_EQUAL_FATAL(scene_load(&s, path), 0);
+    CU_ASSERT_EQUAL(s.num_particles, N);
+    CU_ASSERT_EQUAL(s.num_lines, 3);
+    CU_ASSERT_EQUAL(s.num_squares, 2);
+    CU_ASSERT_DOUBLE_EQUAL(s.width, 800, 0);
+    CU_ASSERT_DOUBLE_EQUAL(s.height, 600, 0);
+    CU_ASSERT_FALSE(memcmp(s.pos_x, px, sizeof(px)));
+    CU_ASSERT_FALSE(memcmp(s.pos_y, py, sizeof(py)));
+    CU_ASSERT_FALSE(memcmp(s.vel_x, vx, sizeof(vx)));
+    CU_ASSERT_FALSE(memcmp(s.vel_y, vy, sizeof(vy)));
+    CU_ASSERT_FALSE(memcmp(s.mass, mass, sizeof(mass)));
+    CU_ASSERT_FALSE(memcmp(s.radius, radius, sizeof(radius)));
+    CU_ASSERT_FALSE(memcmp(s.color, color, sizeof(color)));
+    CU_ASSERT_FALSE(memcmp(s.lines, lines, sizeof(lines)));
+    CU_ASSERT_FALSE(memcmp(s.squares, squares, sizeof(squares)));
+
+    // every section starts on the alignment the loader promises
+    CU_ASSERT_EQUAL(((char *)s.pos_x - (char *)s.base) % SCENE_ALIGN, 0);
+    CU_ASSERT_EQUAL(((char *)s.squares - (char *)s.base) % SCENE_ALIGN, 0);
+
+    // writes go to the private mapping, not the file
+    s.pos_x[0] = 1234.0f;
+    scene_unload(&s);
+    CU_ASSERT_EQUAL_FATAL(scene_load(&s, path), 0);
+    CU_ASSERT_DOUBLE_EQUAL(s.pos_x[0], 0, 0);
+    scene_unload(&s);
+}
+
+// optional sections come back NULL
+static void test_round_trip_positions_only(void) {
+    struct SceneDesc bare = { N, px, py, NULL, NULL, NULL, NULL, NULL, 0, 0, NULL, NULL, 320, 240 };
+    CU_ASSERT_EQUAL_FATAL(scene_write(path, &bare), 0);
+
+    struct Scene s;
+    CU_ASSERT_EQUAL_FATAL(scene_load(&s, path), 0);
+    CU_ASSERT_EQUAL(s.num_particles, N);
+    CU_ASSERT_FALSE(memcmp(s.pos_y, py, sizeof(py)));
+    CU_ASSERT_PTR_NULL(s.vel_x);
+    CU_ASSERT_PTR_NULL(s.color);
+    CU_ASSERT_PTR_NULL(s.lines);
+    CU_ASSERT_EQUAL(s.num_lines, 0);
+    scene_unload(&s);
+}
+
+static void test_write_rejects_bad_extent(void) {
+    struct SceneDesc d = full_desc();
+    d.width = 0;
+    CU_ASSERT_EQUAL(scene_write(path, &d), -1);
+    d.width = 800;
+    d.height = -1;
+    CU_ASSERT_EQUAL(scene_write(path, &d), -1);
+}
+
+// ─── malformed files ─────────────────────────────────────────────
+
+static int load_after_patch(size_t offset, const void *data, size_t size) {
+    struct SceneDesc d = full_desc();
+    if (scene_write(path, &d)) return 0;
+    patch(offset, data, size);
+    struct Scene s;
+    int r = scene_load(&s, path);
+    if (!r) scene_unload(&s);
+    return r;
+}
+
+static void test_rejects_other_endian(void) {
+    uint32_t swapped = 0x04030201u;
+    CU_ASSERT_EQUAL(load_after_patch(offsetof(struct SceneHeader, endian), &swapped, 4), -1);
+}
+
+static void test_rejects_misaligned_sections(void) {
+    uint64_t off = sizeof(struct SceneHeader) + 4;
+    CU_ASSERT_EQUAL(load_after_patch(offsetof(struct SceneHeader, section_offset), &off, 8), -1);
+    off = 8; // inside the header
+    CU_ASSERT_EQUAL(load_after_patch(offsetof(struct SceneHeader, section_offset), &off, 8), -1);
+}
+
+// entry i of the section table the writer put right after the header
+static size_t section_field(int i, size_t field) {
+    return sizeof(struct SceneHeader) + i * sizeof(struct SceneSection) + field;
+}
+
+static void test_rejects_overlapping_sections(void) {
+    struct SceneDesc d = full_desc();
+    CU_ASSERT_EQUAL_FATAL(scene_write(path, &d), 0);
+    struct Scene s;
+    CU_ASSERT_EQUAL_FATAL(scene_load(&s, path), 0);
+    uint64_t pos_x = (uint64_t)((char *)s.pos_x - (char *)s.base);
+    uint64_t vel_x = (uint64_t)((char *)s.vel_x - (char *)s.base);
+    scene_unload(&s);
+
+    // pos_y (entry 1) on top of pos_x
+    CU_ASSERT_EQUAL(load_after_patch(section_field(1, offsetof(struct SceneSection, offset)), &pos_x, 8), -1);
+    // pos_x over the header and table, offset 0 is aligned and in bounds
+    uint64_t zero = 0;
+    CU_ASSERT_EQUAL(load_after_patch(section_field(0, offsetof(struct SceneSection, offset)), &zero, 8), -1);
+    // pos_y starting one alignment step before vel_x and running into it
+    uint64_t before = vel_x - SCENE_ALIGN;
+    CU_ASSERT_EQUAL(load_after_patch(section_field(1, offsetof(struct SceneSection, offset)), &before, 8), -1);
+}
+
+// vel_x (entry 2) relabelled as a second mass, which would otherwise load
+// with the later mass silently winning
+static void test_rejects_duplicate_kind(void) {
+    uint32_t kind = SCENE_MASS;
+    CU_ASSERT_EQUAL(load_after_patch(section_field(2, offsetof(struct SceneSection, kind)), &kind, 4), -1);
+}
+
+static void test_rejects_bad_extent(void) {
+    float zero = 0.0f, nan = 0.0f / 0.0f;
+    CU_ASSERT_EQUAL(load_after_patch(offsetof(struct SceneHeader, width), &zero, 4), -1);
+    CU_ASSERT_EQUAL(load_after_patch(offsetof(struct SceneHeader, height), &nan, 4), -1);
+}
+
+static void test_rejects_truncated(void) {
+    struct SceneDesc d = full_desc();
+    CU_ASSERT_EQUAL_FATAL(scene_write(path, &d), 0);
+    CU_ASSERT_EQUAL_FATAL(truncate(path, 1000), 0);
+    struct Scene s;
+    CU_ASSERT_EQUAL(scene_load(&s, path), -1);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror(path);
+        return 1;
+    }
+    close(fd);
+
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("scene_round_trip", NULL, NULL);
+    CU_add_test(s1, "full",           test_round_trip);
+    CU_add_test(s1, "positions_only", test_round_trip_positions_only);
+    CU_add_test(s1, "bad_extent",     test_write_rejects_bad_extent);
+
+    CU_pSuite s2 = CU_add_suite("scene_malformed", NULL, NULL);
+    CU_add_test(s2, "other_endian", test_rejects_other_endian);
+    CU_add_test(s2, "misaligned",   test_rejects_misaligned_sections);
+    CU_add_test(s2, "overlapping",  test_rejects_overlapping_sections);
+    CU_add_test(s2, "duplicate",    test_rejects_duplicate_kind);
+    CU_add_test(s2, "bad_extent",   test_rejects_bad_extent);
+    CU_add_test(s2, "truncated",    test_rejects_truncated);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+    unlink(path);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "engine/vec2.h"
+#include "engine/collision.h"
+#include "engine/static_world.h"
+#include "engine/rng.h"
+
+#define NUM_LINES 60
+#define NUM_SQUARES 40
+#define NUM_CIRCLES 4000
+
+static struct Line lines[NUM_LINES];
+static struct Square squares[NUM_SQUARES];
+
+static void random_shapes(struct Rng *rng) {
+    for (int i = 0; i < NUM_LINES; i++) {
+        Vec2 a = vec2(rng_range(rng, 0, 1000), rng_range(rng, 0, 1000));
+        Vec2 d = vec2(rng_range(rng, -120, 120), rng_range(rng, -120, 120));
+        lines[i] = (struct Line){ a, vec2_add(a, d) };
+    }
+    for (int i = 0; i < NUM_SQUARES; i++) {
+        squares[i] = (struct Square){ .origin = vec2(rng_range(rng, 0, 1000), rng_range(rng, 0, 1000)),
+                                      .rotation = rng_range(rng, 0, 6.2831853f),
+                                      .width = rng_range(rng, 5, 80), .height = rng_range(rng, 5, 80) };
+    }
+}
+
+static bool brute_hits(int shape, struct Circle c) {
+    return shape < NUM_LINES ? line_vs_circle(lines[shape], c)
+                             : circle_vs_square(c, squares[shape - NUM_LINES]);
+}
+
+static int shape_index(const struct StaticShape *s) {
+    return s->kind == STATIC_LINE ? s->id : NUM_LINES + s->id;
+}
+
+static struct Circle scaled(struct Circle c, float k) {
+    return (struct Circle){ c.origin, c.radius * k };
+}
+
+// ─── query ───────────────────────────────────────────────────────
+
+// the bvh finds exactly what testing every shape finds. circles that
+// graze a shape within float noise may go either way
+static void test_query_matches_brute_force(void) {
+    struct Rng rng;
+    rng_seed(&rng, 11, 0);
+    random_shapes(&rng);
+    struct StaticWorld w;
+    CU_ASSERT_EQUAL_FATAL(static_world_bake(&w, lines, NUM_LINES, squares, NUM_SQUARES), 0);
+
+    int missed = 0, extra = 0, total = 0;
+    for (int k = 0; k < NUM_CIRCLES; k++) {
+        struct Circle c = { vec2(rng_range(&rng, -50, 1050), rng_range(&rng, -50, 1050)),
+                            rng_range(&rng, 1, 30) };
+        int out[NUM_LINES + NUM_SQUARES];
+        bool found[NUM_LINES + NUM_SQUARES] = {0};
+        int hits = static_world_query_circle(&w, c, out, NUM_LINES + NUM_SQUARES);
+        for (int h = 0; h < hits; h++) {
+            int s = shape_index(&w.shapes[out[h]]);
+            found[s] = true;
+            if (!brute_hits(s, scaled(c, 1.001f))) extra++;
+        }
+        for (int s = 0; s < NUM_LINES + NUM_SQUARES; s++) {
+            if (brute_hits(s, scaled(c, 0.999f)) && !found[s]) missed++;
+        }
+        total += hits;
+    }
+    CU_ASSERT_EQUAL(missed, 0);
+    CU_ASSERT_EQUAL(extra, 0);
+    CU_ASSERT_TRUE(total > 100); // the circles actually hit things
+    static_world_free(&w);
+}
+
+// hits past max_out are still counted
+static void test_query_counts_past_max(void) {
+    struct Line fan[8];
+    for (int i = 0; i < 8; i++) {
+        float a = i * 0.785398f;
+        fan[i] = (struct Line){ vec2(100, 100), vec2(100 + 50 * cosf(a), 100 + 50 * sinf(a)) };
+    }
+    struct StaticWorld w;
+    CU_ASSERT_EQUAL_FATAL(static_world_bake(&w, fan, 8, NULL, 0), 0);
+    int out[3];
+    CU_ASSERT_EQUAL(static_world_query_circle(&w, (struct Circle){ vec2(100, 100), 5 }, out, 3), 8);
+    static_world_free(&w);
+}
+
+// ─── resolve ─────────────────────────────────────────────────────
+
+static bool overlaps_any(struct Circle c) {
+    for (int s = 0; s < NUM_LINES + NUM_SQUARES; s++)
+        if (brute_hits(s, c)) return true;
+    return false;
+}
+
+// a resolved circle is clear of every shape. shapes are laid out one per
+// cell with room between them so no circle can be wedged between two
+static void test_resolve_clears_overlap(void) {
+    struct Rng rng;
+    rng_seed(&rng, 12, 0);
+    for (int i = 0; i < NUM_LINES; i++) {
+        Vec2 cell = vec2((i % 10) * 200.0f + 100.0f, (i / 10) * 200.0f + 100.0f);
+        Vec2 d = vec2(rng_range(&rng, -40, 40), rng_range(&rng, -40, 40));
+        lines[i] = (struct Line){ vec2_sub(cell, d), vec2_add(cell, d) };
+    }
+    for (int i = 0; i < NUM_SQUARES; i++) {
+        Vec2 cell = vec2((i % 10) * 200.0f + 100.0f, (i / 10) * 200.0f + 1300.0f);
+        squares[i] = (struct Square){ .origin = cell, .rotation = rng_range(&rng, 0, 6.2831853f),
+                                      .width = rng_range(&rng, 10, 80), .height = rng_range(&rng, 10, 80) };
+    }
+    struct StaticWorld w;
+    CU_ASSERT_EQUAL_FATAL(static_world_bake(&w, lines, NUM_LINES, squares, NUM_SQUARES), 0);
+
+    int resolved = 0, still = 0, wrong = 0;
+    for (int k = 0; k < NUM_CIRCLES; k++) {
+        struct Circle c = { vec2(rng_range(&rng, 0, 2000), rng_range(&rng, 0, 2200)),
+                            rng_range(&rng, 1, 30) };
+        Vec2 push;
+        bool hit = static_world_resolve_circle(&w, c, &push);
+        if (hit != overlaps_any(c) && overlaps_any(scaled(c, 0.999f))) wrong++;
+        if (!hit) continue;
+        resolved++;
+        c.origin = vec2_add(c.origin, push);
+        if (overlaps_any(scaled(c, 0.999f))) still++;
+    }
+    CU_ASSERT_EQUAL(wrong, 0);
+    CU_ASSERT_EQUAL(still, 0);
+    CU_ASSERT_TRUE(resolved > 100);
+    static_world_free(&w);
+}
+
+// a wall split into collinear pieces pushes no further than one piece
+static void test_resolve_collinear_joint(void) {
+    struct Line wall[4];
+    for (int i = 0; i < 4; i++)
+        wall[i] = (struct Line){ vec2(i * 50.0f, 100), vec2((i + 1) * 50.0f, 100) };
+    struct StaticWorld w;
+    CU_ASSERT_EQUAL_FATAL(static_world_bake(&w, wall, 4, NULL, 0), 0);
+
+    Vec2 push;
+    CU_ASSERT_TRUE(static_world_resolve_circle(&w, (struct Circle){ vec2(100, 104), 10 }, &push));
+    CU_ASSERT_DOUBLE_EQUAL(push.x, 0.0, 1e-4);
+    CU_ASSERT_DOUBLE_EQUAL(push.y, 6.0, 1e-4);
+    static_world_free(&w);
+}
+
+// in an inside corner the circle leaves both walls
+static void test_resolve_corner(void) {
+    struct Line walls[2] = {
+        { vec2(0, 0), vec2(200, 0) },
+        { vec2(0, 0), vec2(0, 200) },
+    };
+    struct StaticWorld w;
+    CU_ASSERT_EQUAL_FATAL(static_world_bake(&w, walls, 2, NULL, 0), 0);
+
+    struct Circle c = { vec2(4, 7), 10 };
+    Vec2 push;
+    CU_ASSERT_TRUE(static_world_resolve_circle(&w, c, &push));
+    c.origin = vec2_add(c.origin, push);
+    CU_ASSERT_DOUBLE_EQUAL(c.origin.x, 10.0, 1e-3);
+    CU_ASSERT_DOUBLE_EQUAL(c.origin.y, 10.0, 1e-3);
+    static_world_free(&w);
+}
+
+static void test_resolve_empty(void) {
+    struct StaticWorld w;
+    CU_ASSERT_EQUAL(static_world_bake(&w, NULL, 0, NULL, 0), 0);
+    Vec2 push = vec2(1, 1);
+    CU_ASSERT_FALSE(static_world_resolve_circle(&w, (struct Circle){ vec2(0, 0), 5 }, &push));
+    CU_ASSERT_DOUBLE_EQUAL(push.x, 0.0, 0.0);
+    static_world_free(&w);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("static_world_query", NULL, NULL);
+    CU_add_test(s1, "brute_force", test_query_matches_brute_force);
+    CU_add_test(s1, "past_max",    test_query_counts_past_max);
+
+    CU_pSuite s2 = CU_add_suite("static_world_resolve", NULL, NULL);
+    CU_add_test(s2, "clears_overlap",  test_resolve_clears_overlap);
+    CU_add_test(s2, "collinear_joint", test_resolve_collinear_joint);
+    CU_add_test(s2, "corner",          test_resolve_corner);
+    CU_add_test(s2, "empty",           test_resolve_empty);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "engine/export.h"
+#include "engine/job.h"
+#include "engine/parallel.h"
+#include "sim/particle.h"
+#include "sim/sweep.h"
+
+#define STEPS 20
+#define DT (1.0f / 60.0f)
+#define MAX_ROWS 16
+
+// --G and --target in sweep_params_init order
+#define PARAM_G 1
+#define PARAM_TARGET 2
+
+static struct ParticleParams small_base(void) {
+    struct ParticleParams base = particle_params_default();
+    base.num_particles = 40;
+    return base;
+}
+
+// 2x2 grid over G and target, seeds runs per cell
+static long two_by_two(struct SweepRun *runs, const char *g, const char *target, int seeds) {
+    struct ParticleParams base = small_base();
+    struct SweepParam params[SWEEP_NUM_PARAMS];
+    sweep_params_init(params);
+    if (sweep_parse_list(g, &params[PARAM_G].values) ||
+        sweep_parse_list(target, &params[PARAM_TARGET].values)) return -1;
+    long total = sweep_size(params, SWEEP_NUM_PARAMS, &base, seeds);
+    if (total > MAX_ROWS) return -1;
+    sweep_expand(runs, total, params, SWEEP_NUM_PARAMS, &base, seeds, 7);
+    return total;
+}
+
+// csv lines without the header and without wall_ms, returns the row count
+static int csv_rows(const struct SweepRun *runs, long total, char rows[][512]) {
+    FILE *f = tmpfile();
+    if (!f) return -1;
+    sweep_write_csv(f, runs, total);
+    rewind(f);
+    char line[512];
+    int count = -1; // header
+    while (fgets(line, sizeof(line), f)) {
+        if (count >= 0 && count < MAX_ROWS) {
+            char *wall = strrchr(line, ',');
+            if (wall) *wall = '\0';
+            strcpy(rows[count], line);
+        }
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+// ─── parsing ─────────────────────────────────────────────────────
+
+static void test_parse_list(void) {
+    struct SweepValues v;
+    CU_ASSERT_EQUAL(sweep_parse_list("0.5,1,2", &v), 0);
+    CU_ASSERT_EQUAL(v.count, 3);
+    CU_ASSERT_DOUBLE_EQUAL(v.v[2], 2.0, 1e-6);
+    CU_ASSERT_EQUAL(sweep_parse_list("10:20:3", &v), 0);
+    CU_ASSERT_EQUAL(v.count, 3);
+    CU_ASSERT_DOUBLE_EQUAL(v.v[1], 15.0, 1e-6);
+    CU_ASSERT_EQUAL(sweep_parse_list("1,x", &v), -1);
+    CU_ASSERT_EQUAL(sweep_parse_list("", &v), -1);
+    CU_ASSERT_EQUAL(sweep_parse_list("0:1:0", &v), -1);
+}
+
+static void test_settle_time(void) {
+    const float hot_then_cold[] = {1.0f, 10.0f, 5.0f, 0.5f, 0.05f, 0.01f};
+    CU_ASSERT_DOUBLE_EQUAL(sweep_settle_time(hot_then_cold, 6, 0.5f), 2.0, 1e-6);
+    const float never[] = {1.0f, 2.0f, 3.0f};
+    CU_ASSERT_DOUBLE_EQUAL(sweep_settle_time(never, 3, 0.5f), -1.0, 1e-6);
+    const float still[] = {0.0f, 0.0f};
+    CU_ASSERT_DOUBLE_EQUAL(sweep_settle_time(still, 2, 0.5f), 0.0, 1e-6);
+}
+
+// ─── runs ────────────────────────────────────────────────────────
+
+static void test_grid_rows(void) {
+    static struct SweepRun runs[MAX_ROWS];
+    static char rows[MAX_ROWS][512];
+    const float g[] = {0.05f, 0.2f}, target[] = {80.0f, 140.0f};
+    long total = two_by_two(runs, "0.05,0.2", "80,140", 1);
+    CU_ASSERT_EQUAL_FATAL(total, 4);
+
+    sweep_run(runs, total, STEPS, DT, NULL);
+    CU_ASSERT_EQUAL_FATAL(csv_rows(runs, total, rows), 4);
+
+    // target varies faster than G, every other column keeps its default
+    int ok = 1;
+    for (int r = 0; r < 4; r++) {
+        long run;
+        unsigned long long seed;
+        int n;
+        float row_g, row_target;
+        if (sscanf(rows[r], "%ld,%llu,%d,%g,%g", &run, &seed, &n, &row_g, &row_target) != 5) ok = 0;
+        ok &= run == r && seed == 7 && n == 40;
+        ok &= row_g == g[r / 2] && row_target == target[r % 2];
+        ok &= runs[r].params.G == g[r / 2] && runs[r].params.target_dist == target[r % 2];
+        ok &= runs[r].mean_evals == 40.0f;
+    }
+    CU_ASSERT_TRUE(ok);
+}
+
+// the same params and seed give the same row, whichever thread ran it
+static void test_identical_seeds_identical_rows(void) {
+    static struct SweepRun first[MAX_ROWS], second[MAX_ROWS];
+    static char a[MAX_ROWS][512], b[MAX_ROWS][512];
+
+    parallel_set_thread_count(4);
+    long total = two_by_two(first, "0.1,0.1", "100,120", 2);
+    CU_ASSERT_EQUAL_FATAL(total, 8);
+    CU_ASSERT_EQUAL_FATAL(two_by_two(second, "0.1,0.1", "100,120", 2), 8);
+    sweep_run(first, total, STEPS, DT, NULL);
+    sweep_run(second, total, STEPS, DT, NULL);
+    parallel_set_thread_count(0);
+
+    CU_ASSERT_EQUAL_FATAL(csv_rows(first, total, a), 8);
+    CU_ASSERT_EQUAL_FATAL(csv_rows(second, total, b), 8);
+    int ok = 1;
+    for (int r = 0; r < 8; r++)
+        ok &= strcmp(a[r], b[r]) == 0;
+    CU_ASSERT_TRUE(ok);
+
+    // rows 0-3 and 4-7 repeat the same G, so only the run column differs
+    ok = 1;
+    for (int r = 0; r < 4; r++)
+        ok &= strcmp(strchr(a[r], ','), strchr(a[r + 4], ',')) == 0;
+    CU_ASSERT_TRUE(ok);
+    // the two seeds of one cell do differ
+    CU_ASSERT_NOT_EQUAL(first[0].final_ke, first[1].final_ke);
+}
+
+// only run 0 publishes, one frame per step
+static void test_export_run_zero_only(void) {
+    static struct SweepRun runs[MAX_ROWS];
+    long total = two_by_two(runs, "0.05,0.2", "80,140", 1);
+    CU_ASSERT_EQUAL_FATAL(total, 4);
+
+    char name[64];
+    snprintf(name, sizeof(name), "/test_sweep_%d", (int)getpid());
+    struct Exporter ex;
+    CU_ASSERT_EQUAL_FATAL(export_create(&ex, name, 4, runs[0].params.num_particles), 0);
+    sweep_run(runs, total, STEPS, DT, &ex);
+    CU_ASSERT_EQUAL(ex.header->latest, (uint64_t)STEPS);
+    export_destroy(&ex);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("sweep_parse", NULL, NULL);
+    CU_add_test(s1, "list",   test_parse_list);
+    CU_add_test(s1, "settle", test_settle_time);
+
+    CU_pSuite s2 = CU_add_suite("sweep_run", NULL, NULL);
+    CU_add_test(s2, "grid",      test_grid_rows);
+    CU_add_test(s2, "identical", test_identical_seeds_identical_rows);
+    CU_add_test(s2, "export",    test_export_run_zero_only);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    job_shutdown();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+#include <CUnit/CUnit.h>
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "engine/vec2.h"
+#include "engine/particle.h"
+#include "engine/xpbd.h"
+#include "engine/rng.h"
+#include "engine/job.h"
+
+static struct Particle particle_at(float x, float y) {
+    return (struct Particle){ .position = vec2(x, y), .linear_velocity = vec2(0, 0),
+                              .mass = 1.0f, .color = BLACK, .radius = 1.0f };
+}
+
+// every constraint once in order, and no color but the serial one touches
+// a particle twice
+static int coloring_valid(const struct XpbdSolver *s, int n) {
+    int ok = 1;
+    int *seen = calloc((size_t)s->count, sizeof(int));
+    int *owner = malloc((size_t)n * sizeof(int));
+    for (int color = 0; color < s->num_colors; color++) {
+        for (int i = 0; i < n; i++) owner[i] = -1;
+        for (int k = s->color_start[color]; k < s->color_start[color + 1]; k++) {
+            int c = s->order[k];
+            seen[c]++;
+            if (color == s->serial_color) continue;
+            int a = s->constraints[c].a, b = s->constraints[c].b;
+            if (owner[a] >= 0 || owner[b] >= 0) ok = 0;
+            owner[a] = owner[b] = c;
+        }
+    }
+    for (int c = 0; c < s->count; c++)
+        if (seen[c] != 1) ok = 0;
+    if (s->color_start[s->num_colors] != s->count) ok = 0;
+    free(seen);
+    free(owner);
+    return ok;
+}
+
+// ─── coloring ────────────────────────────────────────────────────
+
+static void test_color_random_graph(void) {
+    enum { N = 500, M = 3000 };
+    struct XpbdSolver s;
+    xpbd_init(&s);
+    struct Rng rng;
+    rng_seed(&rng, 7, 0);
+    for (int k = 0; k < M; k++) {
+        int a = (int)(rng_next(&rng) % N), b = (int)(rng_next(&rng) % N);
+        if (a == b) continue;
+        if (k % 2) xpbd_add_distance(&s, a, b, 1.0f, 0.0f);
+        else xpbd_add_contact(&s, a, b, 1.0f);
+    }
+    CU_ASSERT_EQUAL(xpbd_color(&s, N), 0);
+    CU_ASSERT_TRUE(s.colored);
+    CU_ASSERT_EQUAL(s.serial_color, -1);
+    CU_ASSERT_TRUE(coloring_valid(&s, N));
+
+    // distance constraints stay in front of contacts
+    int front = 1;
+    for (int c = 0; c < s.count; c++)
+        if ((s.constraints[c].kind == XPBD_DISTANCE) != (c < s.num_distance)) front = 0;
+    CU_ASSERT_TRUE(front);
+    xpbd_free(&s);
+}
+
+// more constraints on one particle than there are colors
+static void test_color_overflow_is_serial(void) {
+    enum { N = 101 };
+    struct XpbdSolver s;
+    xpbd_init(&s);
+    for (int i = 1; i < N; i++)
+        xpbd_add_distance(&s, 0, i, 1.0f, 0.0f);
+    CU_ASSERT_EQUAL(xpbd_color(&s, N), 0);
+    CU_ASSERT_TRUE(s.serial_color >= 0);
+    CU_ASSERT_EQUAL(s.color_start[s.serial_color + 1] - s.color_start[s.serial_color], N - 1 - 64);
+    CU_ASSERT_TRUE(coloring_valid(&s, N));
+    xpbd_free(&s);
+}
+
+// ─── solving ─────────────────────────────────────────────────────
+
+static void test_rigid_chain_holds_length(void) {
+    enum { N = 20 };
+    struct Particle p[N];
+    struct XpbdSolver s;
+    xpbd_init(&s);
+    s.iterations = 200;
+    for (int i = 0; i < N; i++) p[i] = particle_at(10.0f * i, 0);
+    for (int i = 0; i + 1 < N; i++) xpbd_add_distance(&s, i, i + 1, 10.0f, 0.0f);
+
+    // yank the ends apart, the chain pulls them back together
+    p[0].linear_velocity = vec2(-300, 50);
+    p[N - 1].linear_velocity = vec2(300, -50);
+    CU_ASSERT_EQUAL(xpbd_step(&s, p, N, 1.0f / 60.0f), 0);
+
+    float worst = 0.0f;
+    for (int i = 0; i + 1 < N; i++)
+        worst = fmaxf(worst, fabsf(vec2_dist(p[i].position, p[i + 1].position) - 10.0f));
+    CU_ASSERT_TRUE(worst < 0.01f);
+    xpbd_free(&s);
+}
+
+static void test_contacts_separate(void) {
+    enum { N = 64 };
+    struct Particle p[N];
+    struct XpbdSolver s;
+    xpbd_init(&s);
+    s.contacts = 1;
+    s.iterations = 20;
+    struct Rng rng;
+    rng_seed(&rng, 3, 0);
+    for (int i = 0; i < N; i++) p[i] = particle_at(rng_range(&rng, 0, 12), rng_range(&rng, 0, 12));
+
+    for (int step = 0; step < 60; step++)
+        CU_ASSERT_EQUAL(xpbd_step(&s, p, N, 1.0f / 60.0f), 0);
+
+    float overlap = 0.0f;
+    for (int i = 0; i < N; i++)
+        for (int j = i + 1; j < N; j++)
+            overlap = fmaxf(overlap, 2.0f - vec2_dist(p[i].position, p[j].position));
+    CU_ASSERT_TRUE(overlap < 0.1f);
+    xpbd_free(&s);
+}
+
+static void test_bounds_clamp(void) {
+    struct Particle p[2] = { particle_at(-5, 5), particle_at(5, 50) };
+    struct XpbdSolver s;
+    xpbd_init(&s);
+    s.bounded = 1;
+    s.bounds_min = vec2(0, 0);
+    s.bounds_max = vec2(10, 10);
+    CU_ASSERT_EQUAL(xpbd_step(&s, p, 2, 1.0f / 60.0f), 0);
+    CU_ASSERT_DOUBLE_EQUAL(p[0].position.x, 1.0f, 1e-5f);
+    CU_ASSERT_DOUBLE_EQUAL(p[1].position.y, 9.0f, 1e-5f);
+    xpbd_free(&s);
+}
+
+// ─── main ────────────────────────────────────────────────────────
+
+int main(void) {
+    if (CU_initialize_registry() != CUE_SUCCESS)
+        return CU_get_error();
+
+    CU_pSuite s1 = CU_add_suite("xpbd_color", NULL, NULL);
+    CU_add_test(s1, "random_graph", test_color_random_graph);
+    CU_add_test(s1, "overflow",     test_color_overflow_is_serial);
+
+    CU_pSuite s2 = CU_add_suite("xpbd_solve", NULL, NULL);
+    CU_add_test(s2, "rigid_chain", test_rigid_chain_holds_length);
+    CU_add_test(s2, "contacts",    test_contacts_separate);
+    CU_add_test(s2, "bounds",      test_bounds_clamp);
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    unsigned int failures = CU_get_number_of_failures();
+    CU_cleanup_registry();
+
+    job_shutdown();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,222 @@
+// builds binary scene files for engine/scene.h.
+//
+//   ./scene_convert scene.txt out.scene           text scene -> binary
+//   ./scene_convert --random 5000000 out.scene    uniform random particles
+//   ./scene_convert --info out.scene              print what a file holds
+//
+// text scenes have one item per line, '#' starts a comment:
+//
+//   size W H
+//   p x y [vx vy [mass [radius [rrggbbaa]]]]
+//   line x0 y0 x1 y1
+//   square x y rotation w h
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine/rng.h"
+#include "engine/scene.h"
+
+#define DEFAULT_COLOR 0x000000ffu // black, opaque
+#define DEFAULT_WIDTH 800.0f
+#define DEFAULT_HEIGHT 600.0f
+
+struct Builder {
+    float *x, *y, *vx, *vy, *mass, *radius;
+    uint32_t *color;
+    uint32_t n, cap;
+
+    struct Line *lines;
+    uint32_t num_lines, cap_lines;
+    struct Square *squares;
+    uint32_t num_squares, cap_squares;
+
+    float width, height;
+};
+
+static int grow(void **buf, uint32_t *cap, uint32_t need, size_t elem) {
+    if (need <= *cap) return 0;
+    uint32_t c = *cap ? *cap * 2 : 1024;
+    while (c < need) c *= 2;
+    void *b = realloc(*buf, (size_t)c * elem);
+    if (!b) return -1;
+    *buf = b;
+    *cap = c;
+    return 0;
+}
+
+static int reserve_particles(struct Builder *b, uint32_t need) {
+    if (need <= b->cap) return 0;
+    uint32_t cap = b->cap ? b->cap : 1024;
+    while (cap < need) cap *= 2;
+
+    // every array grows to the same capacity
+    float **arrays[] = {&b->x, &b->y, &b->vx, &b->vy, &b->mass, &b->radius};
+    for (size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++) {
+        float *a = realloc(*arrays[i], (size_t)cap * sizeof(float));
+        if (!a) return -1;
+        *arrays[i] = a;
+    }
+    uint32_t *color = realloc(b->color, (size_t)cap * sizeof(uint32_t));
+    if (!color) return -1;
+    b->color = color;
+
+    b->cap = cap;
+    return 0;
+}
+
+static int add_particle(struct Builder *b, float x, float y, float vx, float vy,
+                        float mass, float radius, uint32_t color) {
+    if (reserve_particles(b, b->n + 1)) return -1;
+    uint32_t i = b->n++;
+    b->x[i] = x; b->y[i] = y;
+    b->vx[i] = vx; b->vy[i] = vy;
+    b->mass[i] = mass; b->radius[i] = radius;
+    b->color[i] = color;
+    return 0;
+}
+
+static int parse_text(struct Builder *b, FILE *in) {
+    char line[512];
+    int lineno = 0;
+    while (fgets(line, sizeof(line), in)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char kind[16];
+        if (sscanf(line, "%15s", kind) != 1) continue;
+        const char *args = strstr(line, kind) + strlen(kind);
+
+        if (!strcmp(kind, "size")) {
+            if (sscanf(args, "%f %f", &b->width, &b->height) != 2) goto bad;
+        } else if (!strcmp(kind, "p")) {
+            float x, y, vx = 0, vy = 0, mass = 1.0f, radius = 2.0f;
+            unsigned color = DEFAULT_COLOR;
+            int got = sscanf(args, "%f %f %f %f %f %f %x", &x, &y, &vx, &vy, &mass, &radius, &color);
+            if (got < 2 || got == 3) goto bad;
+            if (add_particle(b, x, y, vx, vy, mass, radius, color)) return -1;
+        } else if (!strcmp(kind, "line")) {
+            struct Line l;
+            if (sscanf(args, "%f %f %f %f", &l.start.x, &l.start.y, &l.end.x, &l.end.y) != 4) goto bad;
+            if (grow((void **)&b->lines, &b->cap_lines, b->num_lines + 1, sizeof(l))) return -1;
+            b->lines[b->num_lines++] = l;
+        } else if (!strcmp(kind, "square")) {
+            struct Square s;
+            if (sscanf(args, "%f %f %f %f %f", &s.origin.x, &s.origin.y, &s.rotation, &s.width, &s.height) != 5)
+                goto bad;
+            if (grow((void **)&b->squares, &b->cap_squares, b->num_squares + 1, sizeof(s))) return -1;
+            b->squares[b->num_squares++] = s;
+        } else {
+            goto bad;
+        }
+        continue;
+    bad:
+        fprintf(stderr, "line %d: cant parse '%s'\n", lineno, kind);
+        return -1;
+    }
+    return 0;
+}
+
+static int generate_random(struct Builder *b, uint32_t n, uint64_t seed) {
+    struct Rng rng;
+    rng_seed(&rng, seed, 0);
+    if (reserve_particles(b, n)) return -1;
+    for (uint32_t i = 0; i < n; i++) {
+        add_particle(b, rng_range(&rng, 0.0f, b->width), rng_range(&rng, 0.0f, b->height),
+                     0.0f, 0.0f, 1.0f, 2.0f, DEFAULT_COLOR);
+    }
+    return 0;
+}
+
+static int info(const char *path) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    struct Scene scene;
+    if (scene_load(&scene, path)) {
+        fprintf(stderr, "%s: %s\n", path, errno == EINVAL ? "not a valid scene file" : strerror(errno));
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    printf("%s: %zu bytes, %gx%g world\n", path, scene.size, scene.width, scene.height);
+    printf("  particles %u (vel %s, mass %s, radius %s, color %s)\n", scene.num_particles,
+           scene.vel_x ? "yes" : "no", scene.mass ? "yes" : "no",
+           scene.radius ? "yes" : "no", scene.color ? "yes" : "no");
+    printf("  lines %u, squares %u\n", scene.num_lines, scene.num_squares);
+    printf("  mapped in %.3f ms\n", (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+    scene_unload(&scene);
+    return 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s scene.txt out.scene\n"
+            "       %s --random N [--seed S] [--size W H] out.scene\n"
+            "       %s --info file.scene\n", argv0, argv0, argv0);
+}
+
+int main(int argc, char **argv) {
+    struct Builder b;
+    memset(&b, 0, sizeof(b));
+    b.width = DEFAULT_WIDTH;
+    b.height = DEFAULT_HEIGHT;
+
+    if (argc == 3 && !strcmp(argv[1], "--info"))
+        return info(argv[2]);
+
+    const char *out = NULL;
+    int ok;
+    if (argc >= 4 && !strcmp(argv[1], "--random")) {
+        long n = atol(argv[2]);
+        uint64_t seed = 1;
+        for (int i = 3; i < argc - 1; i++) {
+            if (!strcmp(argv[i], "--seed") && i + 1 < argc - 1) seed = strtoull(argv[++i], NULL, 10);
+            else if (!strcmp(argv[i], "--size") && i + 2 < argc - 1) {
+                b.width = strtof(argv[++i], NULL);
+                b.height = strtof(argv[++i], NULL);
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        if (n <= 0 || n > (long)UINT32_MAX / 2) {
+            usage(argv[0]);
+            return 1;
+        }
+        out = argv[argc - 1];
+        ok = generate_random(&b, (uint32_t)n, seed) == 0;
+    } else if (argc == 3) {
+        FILE *in = fopen(argv[1], "r");
+        if (!in) {
+            perror(argv[1]);
+            return 1;
+        }
+        out = argv[2];
+        ok = parse_text(&b, in) == 0;
+        fclose(in);
+    } else {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (ok) {
+        struct SceneDesc d = {
+            b.n, b.x, b.y, b.vx, b.vy, b.mass, b.radius, b.color,
+            b.num_lines, b.num_squares, b.lines, b.squares,
+            b.width, b.height,
+        };
+        ok = scene_write(out, &d) == 0;
+        if (!ok) perror(out);
+        else printf("%s: %u particles, %u lines, %u squares\n", out, b.n, b.num_lines, b.num_squares);
+    }
+
+    free(b.x); free(b.y); free(b.vx); free(b.vy);
+    free(b.mass); free(b.radius); free(b.color);
+    free(b.lines); free(b.squares);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// watches a live export from engine/export.h.
+//
+//   ./state_reader /physics                  one line per new frame
+//   ./state_reader --hz 10 --frames 100 /physics
+//   ./state_reader --csv /physics > frame.csv  newest frame as x,y,vx,vy
+//
+// frames the reader was too slow for are counted as skipped, the writer
+// never waits.
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine/export.h"
+
+static void sleep_s(double s) {
+    struct timespec ts = {(time_t)s, (long)((s - (time_t)s) * 1e9)};
+    nanosleep(&ts, NULL);
+}
+
+static void summary(const struct ExportReader *rd, const struct ExportFrame *f, uint64_t skipped) {
+    Vec2 sum = vec2(0, 0);
+    float v2 = 0.0f;
+    for (uint32_t i = 0; i < f->count; i++) {
+        sum = vec2_add(sum, export_position(rd, f, i));
+        v2 += vec2_len2(export_velocity(rd, f, i));
+    }
+    float inv = f->count ? 1.0f / f->count : 0.0f;
+    Vec2 c = vec2_scale(sum, inv);
+    printf("frame %llu  t %.3f  n %u (1/%u)  centroid %.1f %.1f  rms speed %.2f  skipped %llu\n",
+           (unsigned long long)f->number, f->time, f->count, f->decimate, c.x, c.y,
+           sqrtf(v2 * inv), (unsigned long long)skipped);
+}
+
+static void dump_csv(const struct ExportReader *rd, const struct ExportFrame *f) {
+    printf("x,y,vx,vy\n");
+    for (uint32_t i = 0; i < f->count; i++) {
+        Vec2 p = export_position(rd, f, i), v = export_velocity(rd, f, i);
+        printf("%g,%g,%g,%g\n", p.x, p.y, v.x, v.y);
+    }
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--hz N] [--frames N] NAME\n"
+                    "       %s --csv NAME\n", argv0, argv0);
+}
+
+int main(int argc, char **argv) {
+    double hz = 30.0;
+    long frames = 0; // 0 runs until killed
+    int csv = 0;
+    int i = 1;
+    for (; i < argc - 1; i++) {
+        if (!strcmp(argv[i], "--csv")) csv = 1;
+        else if (!strcmp(argv[i], "--hz") && i + 1 < argc - 1) hz = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc - 1) frames = atol(argv[++i]);
+        else break;
+    }
+    if (i != argc - 1 || hz <= 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *name = argv[argc - 1];
+
+    struct ExportReader rd;
+    if (export_open(&rd, name)) {
+        fprintf(stderr, "%s: %s\n", name, errno == EINVAL ? "not a particle export" : strerror(errno));
+        return 1;
+    }
+
+    uint64_t last = 0;
+    long seen = 0;
+    while (!frames || seen < frames) {
+        const struct ExportFrame *f;
+        int r = export_read_latest(&rd, &f);
+        if (r == 1 && f->number != last) {
+            if (csv) {
+                dump_csv(&rd, f);
+                break;
+            }
+            summary(&rd, f, last ? f->number - last - 1 : 0);
+            fflush(stdout);
+            last = f->number;
+            seen++;
+        }
+        sleep_s(1.0 / hz);
+    }
+
+    export_close(&rd);
+    return 0;
+}